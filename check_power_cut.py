@@ -0,0 +1,55 @@
+#!/usr/bin/env python3
+# Power cut check of the module data in flash (firmware built with OPENKNX_FLASH_SIMULATION)
+#
+# Usage: check_power_cut.py <serial port> [--passes 1] [--baud 115200] [--timeout 600]
+#
+# Runs the console command "flash torture N": every save is cut once after each erase and each
+# programmed byte, and the recovery has to find the newest or the previous data.
+# Exit code 0 if the device reports "Power cut test OK", otherwise 1.
+# Requires pyserial (installed with platformio).
+import argparse
+import re
+import sys
+import time
+
+import serial
+
+ANSI_SEQUENCE = re.compile(r'\x1b\[[0-9;]*[A-Za-z]|[\b]')
+VERDICT = re.compile(r'Power cut test (OK|FAILED)')
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Check the recovery of OpenKNX module data after power cuts')
+    parser.add_argument('port', help='serial port of the device')
+    parser.add_argument('--passes', type=int, default=1, help='passes over all cut points')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--timeout', type=int, default=600, help='max. seconds to wait for the verdict')
+    args = parser.parse_args()
+
+    device = serial.Serial(args.port, args.baud, timeout=1)
+    device.reset_input_buffer()
+    device.write(('flash torture %i\n' % args.passes).encode('ascii'))
+
+    line = ''
+    end = time.time() + args.timeout
+    while time.time() < end:
+        chunk = device.read(256).decode('utf-8', 'replace')
+        if not chunk:
+            continue
+
+        sys.stdout.write(chunk)
+        sys.stdout.flush()
+        line += chunk
+        for complete in line.split('\n')[:-1]:
+            verdict = VERDICT.search(ANSI_SEQUENCE.sub('', complete))
+            if verdict:
+                sys.exit(0 if verdict.group(1) == 'OK' else 1)
+
+        line = line.split('\n')[-1]
+
+    print('\nNo verdict within %i seconds' % args.timeout)
+    sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+# Decoder for binary log records (OPENKNX_LOGGER_BINARY with OPENKNX_LOGGER_BINARY_OUTPUT)
+#
+# Usage: decode_binary_log.py <firmware.elf> <serial port or file> [--baud 115200] [--word-size 4]
+#
+# The device sends normal text and frames (0x00 ; SIZE[2] ; RECORD). The format strings of the
+# records are read from the elf file, so it must be the elf of the running firmware.
+# Requires pyelftools and pyserial (both are installed with platformio).
+import argparse
+import os
+import re
+import struct
+import sys
+
+from elftools.elf.elffile import ELFFile
+
+# see OpenKNX/Log/BinaryLog.h
+BINARY_LOG_SPEC = re.compile(r'%([-+ #0]*)(\*|\d*)(?:\.(\*|\d*))?(hh|h|ll|l|z|j|t|L)?([diuxXocfFeEgGaAsp%])')
+MAX_PREFIX_LENGTH = 23
+LEVELS = ['trace', 'debug', 'info', 'error']
+
+
+class console_color:
+    RESET = '\033[0m'
+
+
+class StringTable:
+    def __init__(self, path):
+        self.file = open(path, 'rb')
+        self.elf = ELFFile(self.file)
+        self.sections = [s for s in self.elf.iter_sections() if s['sh_flags'] & 2 and s['sh_type'] == 'SHT_PROGBITS']
+        self.cache = {}
+
+    def string(self, address):
+        if address in self.cache:
+            return self.cache[address]
+
+        for section in self.sections:
+            start = section['sh_addr']
+            if start <= address < start + section['sh_size']:
+                data = section.data()
+                offset = address - start
+                end = data.find(b'\0', offset)
+                value = data[offset:end].decode('utf-8', 'replace')
+                self.cache[address] = value
+                return value
+
+        return '<unknown format 0x%08X>' % address
+
+
+class Record:
+    def __init__(self, data, word_size):
+        self.data = data
+        self.position = 0
+        self.word_size = word_size
+
+    def read(self, fmt):
+        value = struct.unpack_from('<' + fmt, self.data, self.position)[0]
+        self.position += struct.calcsize('<' + fmt)
+        return value
+
+    def word(self, signed=True):
+        return self.read(('i' if signed else 'I') if self.word_size == 4 else ('q' if signed else 'Q'))
+
+
+def format_message(fmt, record):
+    def replace(match):
+        flags, width, precision, size, conversion = match.groups()
+        if conversion == '%':
+            return '%'
+
+        if width == '*':
+            width = str(record.read('i'))
+        if precision == '*':
+            precision = str(record.read('i'))
+        spec = '%' + flags + (width or '') + ('.' + precision if precision is not None else '')
+
+        if conversion in 'diuxXoc':
+            signed = conversion in 'di'
+            if size == 'll' or size == 'j':
+                value = record.read('q' if signed else 'Q')
+            elif size in ('l', 'z', 't'):
+                value = record.word(signed)
+            else:
+                value = record.read('i' if signed else 'I')
+            if conversion == 'u':
+                conversion = 'd'
+            return (spec + conversion) % (chr(value) if conversion == 'c' else value)
+
+        if conversion in 'fFeEgGaA':
+            value = record.read('d')
+            return (spec + ('f' if conversion in 'aA' else conversion)) % value
+
+        if conversion == 's':
+            length = record.read('B')
+            value = record.data[record.position:record.position + length].decode('utf-8', 'replace')
+            record.position += length
+            return (spec + 's') % value
+
+        if conversion == 'p':
+            return '0x%x' % record.word(False)
+
+    try:
+        return BINARY_LOG_SPEC.sub(replace, fmt)
+    except struct.error:
+        return fmt + ' <?>'
+
+
+def decode_record(data, strings, word_size):
+    record = Record(data, word_size)
+    address = record.word(False)
+    time = record.read('I')
+    level = record.read('B')
+    color = record.read('B')
+    indent = record.read('B')
+    core = record.read('B')
+    prefix_length = record.read('B')
+    prefix = data[record.position:record.position + prefix_length].decode('utf-8', 'replace')
+    record.position += prefix_length
+
+    message = format_message(strings.string(address), record)
+    line = '%10.6f %-5s %s%-*s%s%s' % (time / 1000000, LEVELS[level] if level < len(LEVELS) else '?', '_1> ' if core else '', MAX_PREFIX_LENGTH + 2, prefix + ':' if prefix else '', '  ' * indent, message)
+    if color:
+        line = '\033[%im%s%s' % (color, line, console_color.RESET)
+    return line
+
+
+def open_input(name, baud):
+    if os.path.exists(name) and not name.startswith('/dev/'):
+        return open(name, 'rb')
+
+    import serial
+    return serial.Serial(name, baud)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decode binary log records of OpenKNX firmware')
+    parser.add_argument('elf', help='elf file of the running firmware')
+    parser.add_argument('input', help='serial port or file with the captured output')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--word-size', type=int, default=4, help='size of pointers and long on the device')
+    args = parser.parse_args()
+
+    strings = StringTable(args.elf)
+    stream = open_input(args.input, args.baud)
+    out = sys.stdout
+
+    while True:
+        byte = stream.read(1)
+        if not byte:
+            break
+
+        if byte != b'\0':
+            out.write(byte.decode('utf-8', 'replace'))
+            continue
+
+        size = struct.unpack('<H', stream.read(2))[0]
+        out.write(decode_record(stream.read(size), strings, args.word_size) + '\n')
+        out.flush()
+
+
+if __name__ == '__main__':
+    main()
@@ -27,11 +27,22 @@
     #endif
 #endif
 
-#ifdef ARDUINO_ARCH_RP2040
-    #if OPENKNX_FLASH_SIZE % 2
-        #error "OPENKNX_FLASH_SIZE cannot be divided by 2"
+#include "OpenKNX/defines.h"
+
+#if defined(ARDUINO_ARCH_RP2040) || defined(ARDUINO_ARCH_SAMD)
+    #if (OPENKNX_FLASH_SIZE - OPENKNX_FLASH_KV_SIZE) % OPENKNX_FLASH_SLOTS
+        #error "OPENKNX_FLASH_SIZE (without OPENKNX_FLASH_KV_SIZE) cannot be divided by OPENKNX_FLASH_SLOTS"
     #endif
+#endif
 
+#ifdef ARDUINO_ARCH_SAMD
+    // a slot is erased while another slot holds the data, so slots must consist of whole NVM rows (SAMD21: 4 pages of 64 bytes)
+    #if (OPENKNX_FLASH_SIZE - OPENKNX_FLASH_KV_SIZE) / OPENKNX_FLASH_SLOTS % 256
+        #error "OPENKNX_FLASH_SIZE (without OPENKNX_FLASH_KV_SIZE) / OPENKNX_FLASH_SLOTS must be a multiple of the NVM row size (256)"
+    #endif
+#endif
+
+#ifdef ARDUINO_ARCH_RP2040
     #if OPENKNX_FLASH_SIZE % 4096
         #error "OPENKNX_FLASH_SIZE must be multiple of 4096"
     #endif
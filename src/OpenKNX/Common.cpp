@@ -1,10 +1,18 @@
 #include "OpenKNX/Common.h"
 #include "OpenKNX/Facade.h"
+#include "OpenKNX/Log/CrashSink.h"
+#include "OpenKNX/Log/DiagnoseKoSink.h"
+#include "OpenKNX/Log/FileSink.h"
+#include "OpenKNX/Log/MemorySink.h"
+#include "OpenKNX/Log/StreamSink.h"
 #include "OpenKNX/Stat/RuntimeStat.h"
+#ifdef OPENKNX_LOGGER_SINK_RTT
+    #include <RTTStream.h>
+#endif
 
 namespace OpenKNX
 {
-    std::string Common::logPrefix()
+    const char* Common::logPrefix()
     {
         return "Common";
     }
@@ -12,6 +20,7 @@ namespace OpenKNX
     void Common::init(uint8_t firmwareRevision)
     {
         ArduinoPlatform::SerialDebug = new OpenKNX::Log::VirtualSerial("KNX");
+        initLogSinks();
 
         openknx.timerInterrupt.init();
         openknx.hardware.initLeds();
@@ -42,6 +51,10 @@ namespace OpenKNX
 #endif
 
         openknx.hardware.initFlash();
+        openknx.keyValue.init();
+#ifdef OPENKNX_FLASH_TELEMETRY
+        openknx.flashTelemetry.init();
+#endif
         openknx.info.serialNumber(knx.platform().uniqueSerialNumber());
         openknx.info.firmwareRevision(firmwareRevision);
 
@@ -54,24 +67,10 @@ namespace OpenKNX
     void Common::showDebugInfo()
     {
         logDebugP("Debug logging is enabled!");
-    #if defined(OPENKNX_TRACE1) || defined(OPENKNX_TRACE2) || defined(OPENKNX_TRACE3) || defined(OPENKNX_TRACE4) || defined(OPENKNX_TRACE5)
+    #ifdef OPENKNX_LOGGER_TRACE_FILTER
         logDebugP("Trace logging is enabled with:");
         logIndentUp();
-        #ifdef OPENKNX_TRACE1
-        logDebugP("Filter 1: %s", TRACE_STRINGIFY(OPENKNX_TRACE1));
-        #endif
-        #ifdef OPENKNX_TRACE2
-        logDebugP("Filter 2: %s", TRACE_STRINGIFY(OPENKNX_TRACE2));
-        #endif
-        #ifdef OPENKNX_TRACE3
-        logDebugP("Filter 3: %s", TRACE_STRINGIFY(OPENKNX_TRACE3));
-        #endif
-        #ifdef OPENKNX_TRACE4
-        logDebugP("Filter 4: %s", TRACE_STRINGIFY(OPENKNX_TRACE4));
-        #endif
-        #ifdef OPENKNX_TRACE5
-        logDebugP("Filter 5: %s", TRACE_STRINGIFY(OPENKNX_TRACE5));
-        #endif
+        openknx.logger.showTraceFilters();
         logIndentDown();
     #endif
     }
@@ -119,6 +118,31 @@ namespace OpenKNX
     }
 #endif
 
+    /*
+     * Additional log outputs beside OPENKNX_LOGGER_DEVICE (see README)
+     */
+    void Common::initLogSinks()
+    {
+#ifdef OPENKNX_LOGGER_SINK_MEMORY
+        openknx.logger.addSink(new Log::MemorySink(OPENKNX_LOGGER_SINK_MEMORY, OPENKNX_LOGGER_SINK_MEMORY_LEVEL));
+#endif
+#ifdef OPENKNX_LOGGER_SINK_SERIAL
+        openknx.logger.addSink(new Log::StreamSink("serial", OPENKNX_LOGGER_SINK_SERIAL, LOGGER_LEVEL_TRACE));
+#endif
+#ifdef OPENKNX_LOGGER_SINK_RTT
+        openknx.logger.addSink(new Log::StreamSink("rtt", *new RTTStream(), LOGGER_LEVEL_TRACE));
+#endif
+#if defined(OPENKNX_LOGGER_SINK_DIAGNOSE) && defined(LOG_KoDiagnose)
+        openknx.logger.addSink(new Log::DiagnoseKoSink(OPENKNX_LOGGER_SINK_DIAGNOSE_LEVEL));
+#endif
+#if defined(OPENKNX_LOGGER_SINK_FILE) && defined(ARDUINO_ARCH_RP2040)
+        openknx.logger.addSink(new Log::FileSink(OPENKNX_LOGGER_SINK_FILE, OPENKNX_LOGGER_SINK_FILE_SIZE, OPENKNX_LOGGER_SINK_FILE_LEVEL));
+#endif
+#if defined(OPENKNX_LOGGER_SINK_CRASH) && defined(ARDUINO_ARCH_RP2040)
+        openknx.logger.addSink(new Log::CrashSink(OPENKNX_LOGGER_SINK_CRASH_LEVEL));
+#endif
+    }
+
     void Common::initKnx()
     {
         logInfoP("Init knx stack");
@@ -358,6 +382,7 @@ namespace OpenKNX
         // loop console helper
         RUNTIME_MEASURE_BEGIN(_runtimeConsole);
         openknx.console.loop();
+        openknx.logger.loop();
         RUNTIME_MEASURE_END(_runtimeConsole);
 
         // loop  knx stack
@@ -380,6 +405,17 @@ namespace OpenKNX
             processSavePin();
             processRestoreSavePin();
             processAfterStartupDelay();
+
+            // requested saves, async save and image for power failure
+            if (!_savePinTriggered)
+            {
+                processSaveRequests();
+                openknx.flash.loop();
+#ifdef OPENKNX_FLASH_TELEMETRY
+                if (!openknx.flash.saving())
+                    openknx.flashTelemetry.persist();
+#endif
+            }
         }
 
         RUNTIME_MEASURE_BEGIN(_runtimeModuleLoop);
@@ -534,9 +570,77 @@ namespace OpenKNX
 
     void Common::triggerSavePin()
     {
+        _savePinTriggeredMicros = micros();
         _savePinTriggered = true;
     }
 
+    void Common::requestSave(Module* module)
+    {
+        for (uint8_t i = 0; i < openknx.modules.count; i++)
+        {
+            if (openknx.modules.list[i] != module)
+                continue;
+
+            // debounce starts again with every request
+            _saveRequested[i] = true;
+            _saveRequestTime[i] = delayTimerInit();
+            _saveRequestPending = true;
+            openknx.flash.moduleDataChanged();
+            return;
+        }
+    }
+
+    /**
+     * Starts one (async) save as soon as the policy of any pending request allows it.
+     * All requests before the start of a save are stored with it.
+     */
+    void Common::processSaveRequests()
+    {
+        if (!_saveRequestPending || openknx.flash.saving())
+            return;
+
+        const uint32_t lastSave = openknx.flash.lastSave();
+        const uint32_t lastFailure = openknx.flash.lastFailure();
+        bool pending = false;
+        bool due = false;
+        for (uint8_t i = 0; i < openknx.modules.count; i++)
+        {
+            if (!_saveRequested[i])
+                continue;
+
+            // already stored by another save
+            if (lastSave > 0 && (int32_t)(lastSave - _saveRequestTime[i]) >= 0)
+            {
+                _saveRequested[i] = false;
+                continue;
+            }
+
+            pending = true;
+            if (due)
+                continue;
+
+            // requests stay pending after a failed save, but are retried with a delay
+            if (lastFailure > 0 && !delayCheck(lastFailure, FLASH_DATA_SAVE_RETRY))
+                continue;
+
+            const SavePolicy policy = openknx.modules.list[i]->savePolicy();
+            if (!delayCheck(_saveRequestTime[i], policy.debounce))
+                continue;
+
+            if (lastSave > 0 && !delayCheck(lastSave, policy.minInterval))
+                continue;
+
+            if (!policy.critical && lastSave > 0 && !delayCheck(lastSave, FLASH_DATA_WRITE_LIMIT))
+                continue;
+
+            due = true;
+        }
+
+        _saveRequestPending = pending;
+        if (due)
+            openknx.flash.saveAsync();
+    }
+
     void Common::processSavePin()
     {
         // savePin not triggered
@@ -577,7 +681,14 @@ namespace OpenKNX
         logIndentDown();
 
         // save data
-        openknx.flash.save();
+        openknx.flash.savePowerFail();
+
+        // latency from interrupt until data is stored
+        const uint32_t latency = micros() - _savePinTriggeredMicros;
+        if (latency > _savePinLatencyMax)
+            _savePinLatencyMax = latency;
+
+        logInfoP("Save latency %ius (max %ius)", latency, _savePinLatencyMax);
 
         // manual recevie stopKnxMode respone
         uint8_t response[2] = {};
@@ -646,7 +757,12 @@ namespace OpenKNX
         }
 
         openknx.flash.save();
+#ifdef OPENKNX_FLASH_TELEMETRY
+        openknx.flashTelemetry.persist(true);
+#endif
+        logInfoP("Flash operations (knx) since tables unload: %i erases, %i programs", openknx.knxFlash.eraseCount(), openknx.knxFlash.programCount());
         logIndentDown();
+        openknx.logger.flush();
     }
 
     void Common::processBeforeTablesUnload()
@@ -659,6 +775,10 @@ namespace OpenKNX
         }
 
         openknx.flash.save();
+
+        // count flash operations of the download
+        openknx.knxFlash.resetStatistic();
+        openknx.openknxFlash.resetStatistic();
         logIndentDown();
     }
 
@@ -736,6 +856,11 @@ namespace OpenKNX
 
     bool Common::processFunctionProperty(uint8_t objectIndex, uint8_t propertyId, uint8_t length, uint8_t* data, uint8_t* resultData, uint8_t& resultLength)
     {
+#ifdef OPENKNX_FLASH_TELEMETRY
+        if (objectIndex == OPENKNX_FLASH_TELEMETRY_PROPERTY_OBJECT && propertyId == OPENKNX_FLASH_TELEMETRY_PROPERTY_ID)
+            return openknx.flashTelemetry.processFunctionProperty(length, data, resultData, resultLength);
+#endif
+
         for (uint8_t i = 0; i < openknx.modules.count; i++)
             if (openknx.modules.list[i]->processFunctionProperty(objectIndex, propertyId, length, data, resultData, resultLength))
                 return true;
@@ -13,6 +13,8 @@
 
 namespace OpenKNX
 {
+    class Module;
+
 #ifdef OPENKNX_WATCHDOG
     struct WatchdogData
     {
@@ -43,6 +45,11 @@ namespace OpenKNX
 
         uint32_t _savedPinProcessed = 0;
         bool _savePinTriggered = false;
+        volatile uint32_t _savePinTriggeredMicros = 0;
+        uint32_t _savePinLatencyMax = 0;
+        bool _saveRequested[OPENKNX_MAX_MODULES] = {};
+        uint32_t _saveRequestTime[OPENKNX_MAX_MODULES] = {};
+        bool _saveRequestPending = false;
         volatile int32_t _freeMemoryMin = 0x7FFFFFFF;
 #ifdef ARDUINO_ARCH_RP2040
         volatile int32_t _freeStackMin = 0x1000;
@@ -52,6 +59,7 @@ namespace OpenKNX
 #endif
 
         void initKnx();
+        void initLogSinks();
 
         void processModulesLoop();
         void registerCallbacks();
@@ -117,12 +125,14 @@ namespace OpenKNX
         bool freeLoopIterate(uint8_t size, uint8_t& position, uint8_t& processed);
 
         void processSavePin();
+        void requestSave(Module* module);
+        void processSaveRequests();
         void processBeforeRestart();
         void processBeforeTablesUnload();
 #if (MASK_VERSION & 0x0900) != 0x0900 // Coupler do not have GroupObjects
         void processInputKo(GroupObject& ko);
 #endif
-        std::string logPrefix();
+        const char* logPrefix();
 
 #ifdef OPENKNX_RUNTIME_STAT
         void showRuntimeStat(const bool stat = true, const bool hist = false);
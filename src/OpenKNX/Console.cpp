@@ -106,7 +106,7 @@ namespace OpenKNX
         }
         else if (cmd == "s" || cmd == "w" || cmd == "save")
         {
-            openknx.flash.save();
+            openknx.flash.saveAsync();
         }
         else if (cmd == "flash knx")
         {
@@ -116,6 +116,71 @@ namespace OpenKNX
         {
             showMemoryContent(openknx.openknxFlash.flashAddress(), openknx.openknxFlash.size());
         }
+        else if (!diagnoseKo && cmd == "flash stats")
+        {
+            showFlashStatistic();
+        }
+#ifdef OPENKNX_FLASH_TELEMETRY
+        else if (!diagnoseKo && cmd == "flash telemetry")
+        {
+            openknx.flashTelemetry.showInformations();
+        }
+#endif
+#ifdef OPENKNX_FLASH_SIMULATION
+        else if (!diagnoseKo && cmd.substr(0, 13) == "flash torture")
+        {
+            openknx.flash.torture(cmd.length() > 14 ? std::stoi(cmd.substr(14)) : 1);
+        }
+        else if (!diagnoseKo && cmd.substr(0, 11) == "flash model")
+        {
+            const uint32_t rounds = cmd.length() > 12 ? std::stoi(cmd.substr(12)) : 1000;
+            for (uint8_t cache : {1, 4})
+            {
+                openknx.openknxFlash.simulateWrites(rounds, cache);
+                openknx.knxFlash.simulateWrites(rounds, cache);
+            }
+        }
+    #ifdef OPENKNX_FLASH_COMPRESSION
+        else if (!diagnoseKo && cmd == "flash bench")
+        {
+            openknx.flash.benchmark();
+        }
+    #endif
+#endif
+        else if (!diagnoseKo && (cmd == "log level"))
+        {
+            openknx.logger.showLevels();
+        }
+        else if (!diagnoseKo && cmd.substr(0, 10) == "log level ")
+        {
+            processLogLevel(cmd.substr(10));
+        }
+        else if (!diagnoseKo && (cmd == "log sink"))
+        {
+            openknx.logger.showSinks();
+        }
+        else if (!diagnoseKo && cmd.substr(0, 9) == "log sink ")
+        {
+            processLogSink(cmd.substr(9));
+        }
+#ifdef OPENKNX_LOGGER_TRACE_FILTER
+        else if (!diagnoseKo && (cmd == "log trace"))
+        {
+            openknx.logger.showTraceFilters();
+        }
+        else if (!diagnoseKo && (cmd == "log trace clear"))
+        {
+            openknx.logger.clearTraceFilters();
+            openknx.logger.showTraceFilters();
+        }
+        else if (!diagnoseKo && cmd.substr(0, 10) == "log trace ")
+        {
+            if (!openknx.logger.addTraceFilter(cmd.substr(10).c_str()))
+                logError("Console", "Trace filter not added (max %i filters with %i chars)", OPENKNX_LOGGER_TRACE_FILTERS, OPENKNX_LOGGER_TRACE_FILTER_LENGTH);
+
+            openknx.logger.showTraceFilters();
+        }
+#endif
         else if (cmd.substr(0, 6) == "mem 0x" && cmd.length() > 6)
         {
             std::string addrstr = cmd.substr(6, cmd.length() - 6);
@@ -201,13 +266,13 @@ namespace OpenKNX
                     openknx.logger.logWithValues("%s: command not found", prompt);
                 }
             }
-            memset(prompt, 0, 15); // Reset Promptbuffer
+            memset(prompt, 0, sizeof(prompt)); // Reset Promptbuffer
         }
 
         if (current == '\b' && strlen(prompt) > 0)
             prompt[strlen(prompt) - 1] = 0x0;
 
-        if (strlen(prompt) < 14 && current >= 32 && current <= 126) // Max. 14 printables chars allowed
+        if (strlen(prompt) < OPENKNX_CONSOLE_INPUT_LENGTH && current >= 32 && current <= 126) // Max. OPENKNX_CONSOLE_INPUT_LENGTH printables chars allowed
             prompt[strlen(prompt)] = current;
 
         openknx.logger.printPrompt();
@@ -329,8 +394,24 @@ namespace OpenKNX
         printHelpLine("version, v", "Show compiled versions");
         printHelpLine("memory, mem", "Show memory usage");
         printHelpLine("mem 0xXXXXXXXX", "Show memory content (64byte) starting at 0xXXXXXXXX");
+        printHelpLine("log level [PREFIX] [LEVEL]", "Show or set log level (trace, debug, info, error, none, default)");
+        printHelpLine("log sink [NAME] [LEVEL]", "Show sinks, content of a sink or set its level");
+#ifdef OPENKNX_LOGGER_TRACE_FILTER
+        printHelpLine("log trace [FILTER|clear]", "Show, add or clear trace filters (regex)");
+#endif
         printHelpLine("flash knx", "Show knx flash content");
         printHelpLine("flash openknx", "Show openknx flash content");
+        printHelpLine("flash stats", "Show flash erase/program operations (since tables unload)");
+#ifdef OPENKNX_FLASH_TELEMETRY
+        printHelpLine("flash telemetry", "Show flash wear and save durations (persistent)");
+#endif
+#ifdef OPENKNX_FLASH_SIMULATION
+        printHelpLine("flash torture [N]", "Cut the power at every step of a save, N passes (default 1)");
+        printHelpLine("flash model [N]", "N random writes checked against a model (default 1000)");
+    #ifdef OPENKNX_FLASH_COMPRESSION
+        printHelpLine("flash bench", "Compare save with and without compression");
+    #endif
+#endif
 #ifdef ARDUINO_ARCH_RP2040
         printHelpLine("files, fs", "Show files on filesystem");
 #endif
@@ -359,6 +440,75 @@ namespace OpenKNX
         logEnd();
     }
 
+    void Console::processLogLevel(std::string args)
+    {
+        std::string prefix = "";
+        std::string name = args;
+        size_t separator = args.rfind(' ');
+        if (separator != std::string::npos)
+        {
+            prefix = args.substr(0, separator);
+            name = args.substr(separator + 1);
+        }
+
+        uint8_t level = Log::Logger::levelByName(name.c_str());
+        if (level == LOGGER_LEVEL_DEFAULT && name != "default")
+        {
+            logError("Console", "Unknown log level \"%s\"", name.c_str());
+            return;
+        }
+
+        if (prefix.empty())
+        {
+            if (level == LOGGER_LEVEL_DEFAULT)
+                level = OPENKNX_LOGGER_LEVEL;
+
+            openknx.logger.level(level);
+        }
+        else if (!openknx.logger.level(prefix.c_str(), level))
+        {
+            logError("Console", "Too many log levels (max %i)", OPENKNX_LOGGER_LEVELS);
+            return;
+        }
+
+        openknx.logger.showLevels();
+    }
+
+    void Console::processLogSink(std::string args)
+    {
+        std::string name = args;
+        std::string levelName = "";
+        size_t separator = args.find(' ');
+        if (separator != std::string::npos)
+        {
+            name = args.substr(0, separator);
+            levelName = args.substr(separator + 1);
+        }
+
+        Log::Sink* sink = openknx.logger.sink(name.c_str());
+        if (sink == nullptr)
+        {
+            logError("Console", "Unknown sink \"%s\"", name.c_str());
+            return;
+        }
+
+        if (levelName.empty())
+        {
+            sink->show();
+            return;
+        }
+
+        uint8_t level = Log::Logger::levelByName(levelName.c_str());
+        if (level == LOGGER_LEVEL_DEFAULT)
+        {
+            logError("Console", "Unknown log level \"%s\"", levelName.c_str());
+            return;
+        }
+
+        sink->level(level);
+        openknx.logger.showSinks();
+    }
+
     void Console::sleep()
     {
         openknx.logger.logWithValues("sleep %ims", sleepTime());
@@ -425,6 +575,15 @@ namespace OpenKNX
 #endif
     }
 
+    void Console::showFlashStatistic()
+    {
+        openknx.logger.logWithPrefixAndValues("Flash knx", "%i erases, %i programs", openknx.knxFlash.eraseCount(), openknx.knxFlash.programCount());
+        openknx.logger.logWithPrefixAndValues("Flash openknx", "%i erases, %i programs", openknx.openknxFlash.eraseCount(), openknx.openknxFlash.programCount());
+#if OPENKNX_FLASH_KV_SIZE > 0
+        openknx.logger.logWithPrefixAndValues("Flash key/value", "%i/%i bytes used", openknx.keyValue.used(), openknx.keyValue.available());
+#endif
+    }
+
     void Console::showMemoryContent(uint8_t* start, uint32_t size)
     {
         const size_t lineLen = 16;
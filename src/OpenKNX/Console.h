@@ -14,6 +14,11 @@ extern "C"
 
 #define CONSOLE_HEADLINE_COLOR 33
 
+// max. printable chars of a console command
+#ifndef OPENKNX_CONSOLE_INPUT_LENGTH
+    #define OPENKNX_CONSOLE_INPUT_LENGTH 40
+#endif
+
 namespace OpenKNX
 {
 
@@ -40,9 +45,12 @@ namespace OpenKNX
         void showUptime(bool diagnoseKo = false);
         void showMemory(bool diagnoseKo = false);
         void showMemoryContent(uint8_t* start, uint32_t size);
+        void showFlashStatistic();
         void showMemoryLine(uint8_t* line, uint32_t length, uint8_t* memoryStart);
 
         void showHelp();
+        void processLogLevel(std::string args);
+        void processLogSink(std::string args);
         void sleep();
         uint32_t sleepTime();
 #ifdef ARDUINO_ARCH_RP2040
@@ -53,7 +61,7 @@ namespace OpenKNX
 #endif
 
       public:
-        char prompt[15] = {};
+        char prompt[OPENKNX_CONSOLE_INPUT_LENGTH + 1] = {};
         void loop();
 
         void printHelpLine(const char* command, const char* message);
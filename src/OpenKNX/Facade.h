@@ -3,6 +3,8 @@
 #include "OpenKNX/Common.h"
 #include "OpenKNX/Console.h"
 #include "OpenKNX/Flash/Default.h"
+#include "OpenKNX/Flash/KeyValue.h"
+#include "OpenKNX/Flash/Telemetry.h"
 #include "OpenKNX/Hardware.h"
 #include "OpenKNX/Information.h"
 #include "OpenKNX/Log/Logger.h"
@@ -34,6 +36,10 @@ namespace OpenKNX
       public:
         Common common;
         Flash::Default flash;
+        Flash::KeyValue keyValue;
+#ifdef OPENKNX_FLASH_TELEMETRY
+        Flash::Telemetry flashTelemetry;
+#endif
         Information info;
         Console console;
         Log::Logger logger;
@@ -0,0 +1,16 @@
+#pragma once
+#include <Arduino.h>
+
+namespace OpenKNX
+{
+    namespace Flash
+    {
+        /**
+         * CRC-32 (IEEE 802.3, as used by zlib) with slicing-by-4 - processes one word per step.
+         * Can be calculated incrementally: crc32(crc32(0, a, n), b, m) == crc32(0, ab, n + m)
+         *
+         * @param crc result of the previous block (0 for the first block)
+         */
+        uint32_t crc32(uint32_t crc, const uint8_t *data, uint32_t size);
+    } // namespace Flash
+} // namespace OpenKNX
\ No newline at end of file
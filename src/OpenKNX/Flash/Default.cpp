@@ -7,14 +7,23 @@ namespace OpenKNX
     {
         uint8_t Default::nextVersion()
         {
-#ifdef ARDUINO_ARCH_RP2040
+#ifdef FLASH_DATA_MULTI_SLOT
             return slotVersion(_activeSlot) + 1;
 #else
             return 0xFF;
 #endif
         }
 
-        std::string Default::logPrefix()
+        /**
+         * Compare versions of two slots in serial number arithmetic, to handle the overflow of VERSION.
+         * Requires, that all versions in the ring are within a window of less than 128 saves.
+         */
+        bool Default::isNewerVersion(uint8_t version, uint8_t reference)
+        {
+            return (int8_t)(version - reference) > 0;
+        }
+
+        const char *Default::logPrefix()
         {
             return "Flash<Default>";
         }
@@ -22,36 +31,11 @@ namespace OpenKNX
         void Default::load()
         {
             const uint32_t start = millis();
-            loadedModules = new bool[openknx.modules.count];
             logInfoP("Load data from flash");
             logIndentUp();
-            bool found = false;
-            const bool slotValidA = validateSlot(false);
-            if (slotValidA)
-                found = true;
 
-#ifdef ARDUINO_ARCH_RP2040
-            const bool slotValidB = validateSlot(true);
-            const uint8_t slotVersionA = slotVersion(false);
-            const uint8_t slotVersionB = slotVersion(true);
-            if (slotValidB)
-            {
-                found = true;
-
-                if (
-                    // when slot b valid und slot a not
-                    !slotValidA ||
-                    // when slot b newer than slot a
-                    (
-                        (slotVersionB != 0xFF && slotVersionA < slotVersionB) ||
-                        (slotVersionA == 0xFF && slotVersionB == 0x0)))
-                {
-                    _activeSlot = true;
-                }
-            }
-#endif
-
-            if (!found)
+            initSlots();
+            if (!selectSlot() && !selectLegacySlot())
             {
                 logInfoP("Abort: No valid data found");
                 logIndentDown();
@@ -60,6 +44,7 @@ namespace OpenKNX
 
             loadModuleData();
             initUnloadedModules();
+            moduleDataChanged();
 
             // erase next slot
             eraseSlot(nextSlot());
@@ -68,24 +53,214 @@ namespace OpenKNX
             logIndentDown();
         }
 
-        uint16_t Default::slotOffset(bool slot)
+        /**
+         * Select the valid slot with the newest version as active slot
+         * @return false if no valid slot found
+         */
+        bool Default::selectSlot()
+        {
+            bool found = false;
+            uint8_t activeVersion = 0;
+            for (uint8_t slot = 0; slot < _slots; slot++)
+            {
+                if (!validateSlot(slot))
+                    continue;
+
+                // the newest valid slot wins
+                const uint8_t version = slotVersion(slot);
+                if (!found || isNewerVersion(version, activeVersion))
+                {
+                    _activeSlot = slot;
+                    activeVersion = version;
+                }
+
+                found = true;
+            }
+
+            return found;
+        }
+
+        /**
+         * Select the newest valid slot of the layout before the ring (data of an older version of OGM-Common).
+         * The next slot is the first ring slot not overlapping this data, so it survives until the first save.
+         * @return false if no valid slot found
+         */
+        bool Default::selectLegacySlot()
         {
-#ifdef ARDUINO_ARCH_RP2040
-            return slotSize() + (slot ? slotSize() : 0);
+#ifdef FLASH_DATA_LEGACY_SLOTS
+            bool found = false;
+            uint8_t activeVersion = 0;
+            for (uint8_t slot = FLASH_DATA_LEGACY_SLOT; slot < FLASH_DATA_LEGACY_SLOT + FLASH_DATA_LEGACY_SLOTS; slot++)
+            {
+                if (!validateSlot(slot))
+                    continue;
+
+                const uint8_t version = slotVersion(slot);
+                if (!found || isNewerVersion(version, activeVersion))
+                {
+                    _activeSlot = slot;
+                    activeVersion = version;
+                }
+
+                found = true;
+            }
+
+            if (!found)
+                return false;
+
+            const uint8_t metaLen = metaLength(slotFormat(_activeSlot));
+            _currentReadAddress = slotOffset(_activeSlot) - metaLen + FLASH_DATA_APP_LEN;
+            _legacyDataStart = slotOffset(_activeSlot) - metaLen - readWord();
+            logInfoP("Data found in slot %i of the layout before the ring (moved into slot %i on next save)", _activeSlot - FLASH_DATA_LEGACY_SLOT, nextSlot());
+            return true;
 #else
-            return slotSize();
+            return false;
+#endif
+        }
+
+        /**
+         * Slot overlaps the data of an active legacy slot, which must be kept until the first save
+         */
+        bool Default::overlapsLegacyData(uint8_t slot)
+        {
+            return _activeSlot >= FLASH_DATA_LEGACY_SLOT &&
+                   slotOffset(slot) - slotSize() < slotOffset(_activeSlot) &&
+                   _legacyDataStart < slotOffset(slot);
+        }
+
+#ifdef OPENKNX_FLASH_SIMULATION
+        /**
+         * Saves all modules with a (simulated) power cut at each erase and each programmed byte of the save,
+         * so every phase of a save is cut once per pass. Each pass starts at the slot where the previous one ended.
+         * After each cut the recovery is checked like on startup (valid slot with newest or previous data).
+         * The last line is the verdict "Power cut test OK" or "Power cut test FAILED" (for scripted checks).
+         */
+        void Default::torture(uint32_t passes)
+        {
+            Driver &flash = openknx.openknxFlash;
+            logInfoP("Torture with %i passes (format v4, %i slots with %i bytes)", passes, _slots, slotSize());
+            logIndentUp();
+            if (_slots < 2)
+                logInfoP("A single slot is erased before it is written, so a cut in between loses the data (expected to fail)");
+
+            // reference save without cut (after one save to fill all slots): latency and number of operations
+            _activeSlotCurrent = false;
+            save(true);
+            _activeSlotCurrent = false;
+            const uint32_t startMicros = flash.simulatedMicros();
+            const uint32_t startUnits = flash.simulatedUnits();
+            save(true);
+            const uint32_t saveMicros = flash.simulatedMicros() - startMicros;
+            const uint32_t saveUnits = flash.simulatedUnits() - startUnits;
+
+            uint32_t rounds = 0;
+            uint32_t recovered = 0;
+            uint32_t newest = 0;
+            // version of the last recovered save, independent of the slot selection
+            uint8_t previousVersion = slotVersion(_activeSlot);
+            for (uint32_t pass = 0; pass < passes; pass++)
+            {
+                // cut before the first erase up to after the last programmed byte
+                for (uint32_t cut = 0; cut <= saveUnits; cut++)
+                {
+                    // force a complete rewrite
+                    _activeSlotCurrent = false;
+                    flash.simulatePowerCut(cut);
+                    save(true);
+                    flash.simulatePowerOn();
+                    rounds++;
+
+                    // restart
+                    _activeSlotCurrent = false;
+                    if (!selectSlot())
+                    {
+                        logErrorP("Cut after %i of %i operations: no valid slot", cut, saveUnits);
+                        continue;
+                    }
+
+                    // a cut after the last operation has to keep the complete save
+                    const uint8_t version = slotVersion(_activeSlot);
+                    if (version == (uint8_t)(previousVersion + 1))
+                        newest++;
+                    else if (version != previousVersion || cut == saveUnits)
+                    {
+                        logErrorP("Cut after %i of %i operations: unexpected version %i (previous %i)", cut, saveUnits, version, previousVersion);
+                        continue;
+                    }
+
+                    previousVersion = version;
+                    recovered++;
+                }
+            }
+
+            logInfoP("Recovered %i/%i (%i with newest data, %i with previous data)", recovered, rounds, newest, recovered - newest);
+            logInfoP("Simulated save latency %ius (%i programmed bytes and erased sectors)", saveMicros, saveUnits);
+            logIndentDown();
+            logInfoP("Power cut test %s", recovered == rounds ? "OK" : "FAILED");
+        }
+
+    #ifdef OPENKNX_FLASH_COMPRESSION
+        void Default::benchmark()
+        {
+            Driver &flash = openknx.openknxFlash;
+            logInfoP("Benchmark compression");
+            logIndentUp();
+
+            for (uint8_t compression = 0; compression < 2; compression++)
+            {
+                _compression = compression;
+
+                // force a complete rewrite
+                _activeSlotCurrent = false;
+                const uint32_t startMicros = flash.simulatedMicros();
+                const uint32_t startUnits = flash.simulatedUnits();
+                save(true);
+                logInfoP("%s: %i bytes, simulated save latency %ius (%i programmed bytes and erased sectors)", compression ? "Compressed" : "Uncompressed", _activeDataSize + FLASH_DATA_META_LEN, flash.simulatedMicros() - startMicros, flash.simulatedUnits() - startUnits);
+            }
+
+            _compression = true;
+            logIndentDown();
+        }
+    #endif
 #endif
+
+        uint32_t Default::slotOffset(uint8_t slot)
+        {
+            if (slot >= FLASH_DATA_LEGACY_SLOT)
+                return legacySlotSize() * (slot - FLASH_DATA_LEGACY_SLOT + 1);
+
+            // the key/value store is located in front of the slots
+            return OPENKNX_FLASH_KV_SIZE + slotSize() * (slot + 1);
+        }
+
+        uint32_t Default::slotSize()
+        {
+            return (openknx.openknxFlash.size() - OPENKNX_FLASH_KV_SIZE) / _slots;
         }
 
-        uint16_t Default::slotSize()
+        uint32_t Default::legacySlotSize()
         {
-#ifdef ARDUINO_ARCH_RP2040
-            return openknx.openknxFlash.size() / 2;
+#ifdef FLASH_DATA_LEGACY_SLOTS
+            return openknx.openknxFlash.size() / FLASH_DATA_LEGACY_SLOTS;
 #else
-            return openknx.openknxFlash.size();
+            return 0;
 #endif
         }
 
+        /**
+         * A slot is erased while another slot holds the active data, so slots must not share a sector.
+         * The sector size is only known at runtime (NVM row on SAMD), so fallback to a single slot.
+         */
+        void Default::initSlots()
+        {
+            _slots = FLASH_DATA_SLOTS;
+            if (_slots == 1 || slotSize() % openknx.openknxFlash.sectorSize() == 0)
+                return;
+
+            logErrorP("Slot size %i is not a multiple of the sector size %i, use a single slot", slotSize(), openknx.openknxFlash.sectorSize());
+            _slots = 1;
+        }
+
         uint32_t Default::readOffset()
         {
             return slotOffset(_activeSlot);
@@ -96,37 +271,41 @@ namespace OpenKNX
             return slotOffset(nextSlot());
         }
 
-        bool Default::nextSlot()
+        uint8_t Default::nextSlot()
         {
-#ifdef ARDUINO_ARCH_RP2040
-            return !_activeSlot;
-#else
-            return false;
-#endif
+            // data in a legacy slot: first ring slot without overlap (or the last slot)
+            if (_activeSlot >= FLASH_DATA_LEGACY_SLOT)
+            {
+                uint8_t slot = 0;
+                while (slot < _slots - 1 && overlapsLegacyData(slot))
+                    slot++;
+
+                return slot;
+            }
+
+            return (_activeSlot + 1) % _slots;
         }
 
-        bool Default::validateSlot(bool slot)
+        bool Default::validateSlot(uint8_t slot)
         {
-
-#ifndef ARDUINO_ARCH_RP2040
-            if (slot)
-                return false;
-#endif
             logDebugP("Validate slot %i", slot);
             logIndentUp();
-            logHexTraceP(openknx.openknxFlash.flashAddress() + slotOffset(slot) - FLASH_DATA_META_LEN, FLASH_DATA_META_LEN);
 
             // validate magicwords exists (at last position)
-            _currentReadAddress = slotOffset(slot) - FLASH_DATA_INIT_LEN;
-            if (FLASH_DATA_INIT != readInt())
+            const uint8_t format = slotFormat(slot);
+            if (format == 0)
             {
                 logDebugP("No data found");
                 logIndentDown();
                 return false;
             }
 
+            const uint8_t metaLen = metaLength(format);
+            logDebugP("Format: v%i", format);
+            logHexTraceP(openknx.openknxFlash.flashAddress() + slotOffset(slot) - metaLen, metaLen);
+
             // validate FirmwareVersion/Number
-            _currentReadAddress = slotOffset(slot) - FLASH_DATA_META_LEN;
+            _currentReadAddress = slotOffset(slot) - metaLen;
             _lastFirmwareNumber = readWord();
             logDebugP("Firmware number: 0x%04X", _lastFirmwareNumber);
             _lastFirmwareVersion = readWord();
@@ -149,16 +328,25 @@ namespace OpenKNX
 
             logDebugP("Version: %i", version);
 
-            const uint16_t checksum = readWord();
-            logDebugP("Checksum: %i", checksum);
+            const uint32_t checksum = (format == 1) ? readWord() : readInt();
+            logDebugP("Checksum: %u", checksum);
+
+            // SIZE was partially written or is broken
+            const uint32_t size = (slot >= FLASH_DATA_LEGACY_SLOT) ? legacySlotSize() : slotSize();
+            if (dataSize + metaLen > size)
+            {
+                logErrorP("Data size invalid!");
+                logIndentDown();
+                return false;
+            }
 
             // validate checksum
-            _currentReadAddress = slotOffset(slot) - FLASH_DATA_META_LEN - dataSize;
+            _currentReadAddress = slotOffset(slot) - metaLen - dataSize;
             const uint16_t checksumSize = dataSize + FLASH_DATA_APP_LEN + FLASH_DATA_SIZE_LEN + FLASH_DATA_VERSION;
-            if (!verifyChecksum(currentFlash(), checksumSize, checksum))
+            if (!verifyChecksum(format, currentFlash(), checksumSize, checksum))
             {
                 logErrorP("Checksum invalid!");
-                logHexErrorP(openknx.openknxFlash.flashAddress() + slotOffset(slot) - FLASH_DATA_META_LEN - dataSize, checksumSize);
+                logHexErrorP(openknx.openknxFlash.flashAddress() + slotOffset(slot) - metaLen - dataSize, checksumSize);
                 logIndentDown();
                 return false;
             }
@@ -167,16 +355,49 @@ namespace OpenKNX
             return true;
         }
 
-        uint8_t Default::slotVersion(bool slot)
+        uint8_t Default::slotVersion(uint8_t slot)
         {
-#ifndef ARDUINO_ARCH_RP2040
-            if (slot)
-                return false;
-#endif
-            _currentReadAddress = slotOffset(slot) - FLASH_DATA_INIT_LEN - FLASH_DATA_CHK_LEN - FLASH_DATA_VERSION;
+            _currentReadAddress = slotOffset(slot) - metaLength(slotFormat(slot)) + FLASH_DATA_APP_LEN + FLASH_DATA_SIZE_LEN;
             return readByte();
         }
 
+        /**
+         * @return format version of data in slot (based on INIT) or 0 if no data found
+         */
+        uint8_t Default::slotFormat(uint8_t slot)
+        {
+            _currentReadAddress = slotOffset(slot) - FLASH_DATA_INIT_LEN;
+            switch (readInt())
+            {
+                case FLASH_DATA_INIT:
+                    return 4;
+                case FLASH_DATA_INIT_V3:
+                    return 3;
+                case FLASH_DATA_INIT_V2:
+                    return 2;
+                case FLASH_DATA_INIT_V1:
+                    return 1;
+                default:
+                    return 0;
+            }
+        }
+
+        uint8_t Default::metaLength(uint8_t format)
+        {
+            return (format == 1) ? FLASH_DATA_META_V1_LEN : FLASH_DATA_META_LEN;
+        }
+
+        uint8_t Default::moduleMetaLength(uint8_t format)
+        {
+            if (format < 3)
+                return FLASH_DATA_MODULE_ID_LEN + FLASH_DATA_SIZE_LEN;
+
+            if (format == 3)
+                return FLASH_DATA_MODULE_ID_LEN + FLASH_DATA_SIZE_LEN + FLASH_DATA_MODULE_VERSION_LEN;
+
+            return FLASH_DATA_MODULE_META_LEN;
+        }
+
         /**
          * Initialize all modules expecting data in flash, but not loaded yet.
          */
@@ -186,22 +407,25 @@ namespace OpenKNX
             {
                 // check module expectation and load state
                 Module *module = openknx.modules.list[i];
-                const uint8_t moduleId = openknx.modules.ids[i];
                 const uint16_t moduleSize = module->flashSize();
 
-                if (moduleSize > 0 && !loadedModules[moduleId])
+                if (moduleSize > 0 && !_records[i].loaded)
                 {
-                    logDebugP("Init unloaded module %s (%i)", module->name().c_str(), moduleId);
+                    logDebugP("Init unloaded module %s (%i)", module->name().c_str(), openknx.modules.ids[i]);
                     module->readFlash(new uint8_t[0], 0);
                 }
             }
         }
 
-        void Default::eraseSlot(bool slot)
+        void Default::eraseSlot(uint8_t slot)
         {
-#ifdef ARDUINO_ARCH_RP2040
-            // On RP2020 we need to erase next slot for fast writing on powerloss
-    #ifdef OPENKNX_DEBUG
+#ifdef FLASH_DATA_MULTI_SLOT
+            // On RP2040 and SAMD we need to erase next slot for fast writing on powerloss
+            // the active slot must never be erased (single slot), also not the data of a legacy slot
+            if (slot == _activeSlot || overlapsLegacyData(slot))
+                return;
+
+    #if OPENKNX_LOGGER_LEVEL_MIN <= LOGGER_LEVEL_DEBUG
             const uint32_t start = millis();
     #endif
             logDebugP("Erase slot %i", slot);
@@ -218,73 +442,261 @@ namespace OpenKNX
             logInfoP("Load module data (from slot %i)", _activeSlot);
             logIndentUp();
 
-            // reread data size for calc
-            _currentReadAddress = readOffset() - FLASH_DATA_INIT_LEN - FLASH_DATA_CHK_LEN - FLASH_DATA_VERSION - FLASH_DATA_SIZE_LEN;
+            // reread app version and data size of active slot
+            const uint8_t format = slotFormat(_activeSlot);
+            const uint8_t metaLen = metaLength(format);
+            _currentReadAddress = readOffset() - metaLen + FLASH_DATA_APP_LEN / 2;
+            _lastFirmwareVersion = readWord();
             const uint16_t dataSize = readWord();
 
+            // unchanged module data can be skipped on next save, as long as the firmware and format is the same
+            _activeSlotCurrent = (_lastFirmwareVersion == openknx.info.firmwareVersion() && format == 4);
+            _activeDataSize = dataSize;
+
             // process data
-            _currentReadAddress = readOffset() - FLASH_DATA_META_LEN - dataSize;
+            _currentReadAddress = readOffset() - metaLen - dataSize;
 
             uint32_t dataProcessed = 0;
             while (dataProcessed < dataSize)
             {
                 uint8_t moduleId = readByte();
                 uint16_t moduleSize = readWord();
+                uint8_t moduleVersion = (format < 3) ? 0 : readByte();
+                uint8_t moduleFlags = (format < 4) ? 0 : readByte();
                 Module *module = openknx.getModule(moduleId);
-                dataProcessed += FLASH_DATA_MODULE_ID_LEN + FLASH_DATA_SIZE_LEN + moduleSize;
+                dataProcessed += moduleMetaLength(format) + moduleSize;
                 if (module == nullptr)
                 {
                     logInfoP("Skip module with id %i (not found)", moduleId);
                 }
                 else
                 {
-                    logInfoP("Restore module %s (%i) with %i bytes", module->name().c_str(), moduleId, moduleSize);
+                    logInfoP("Restore module %s (%i) with %i bytes (version %i%s)", module->name().c_str(), moduleId, moduleSize, moduleVersion, (moduleFlags & FLASH_DATA_MODULE_COMPRESSED) ? ", compressed" : "");
                     logIndentUp();
                     logHexTraceP(currentFlash(), moduleSize);
-                    module->readFlash(currentFlash(), moduleSize);
-                    loadedModules[moduleId] = true;
+                    ModuleRecord &record = _records[moduleIndex(moduleId)];
+                    record.address = _currentReadAddress;
+                    record.size = moduleSize;
+                    record.stored = true;
+
+                    uint16_t restoreSize = moduleSize;
+                    if (moduleFlags & FLASH_DATA_MODULE_COMPRESSED)
+                    {
+                        // the module gets the decoded data from a temporary buffer
+                        const int32_t decodedSize = runLengthDecode(currentFlash(), moduleSize, nullptr, 0);
+                        if (decodedSize >= 0 && decodedSize <= 0xFFFF)
+                        {
+                            uint8_t *buffer = new uint8_t[decodedSize];
+                            runLengthDecode(currentFlash(), moduleSize, buffer, decodedSize);
+                            _readBuffer = buffer;
+                            _readBufferOffset = _currentReadAddress;
+                            restoreSize = decodedSize;
+                        }
+                        else
+                        {
+                            logErrorP("Invalid compressed data");
+                            record.stored = false;
+                        }
+                    }
+
+                    if (record.stored)
+                    {
+                        record.fingerprint = moduleFingerprint(moduleId, restoreSize, moduleVersion);
+                        record.fingerprint = calcFingerprint(record.fingerprint, currentFlash(), restoreSize);
+
+                        restoreModule(module, currentFlash(), restoreSize, moduleVersion);
+                        record.loaded = true;
+                    }
+
+                    delete[] _readBuffer;
+                    _readBuffer = nullptr;
                     logIndentDown();
                 }
-                _currentReadAddress = readOffset() - FLASH_DATA_META_LEN - dataSize + dataProcessed;
+                _currentReadAddress = readOffset() - metaLen - dataSize + dataProcessed;
             }
             logIndentDown();
         }
 
+        /**
+         * Pass module data to the module, data of another schema version is migrated by the module.
+         * Without migration the module is initialized like without data.
+         */
+        void Default::restoreModule(Module *module, const uint8_t *data, uint16_t size, uint8_t version)
+        {
+            if (version == module->flashVersion())
+            {
+                module->readFlash(data, size);
+                return;
+            }
+
+            logInfoP("Migrate from version %i to %i", version, module->flashVersion());
+            if (module->migrateFlash(data, size, version))
+                return;
+
+            logInfoP("Migration not supported - discard data");
+            module->readFlash(data, 0);
+        }
+
+        /**
+         * Dry run of writeFlash for all modules to determine the fingerprints of the module data
+         * and the size of MOD_DATA (with OPENKNX_FLASH_COMPRESSION the encoded size if it is smaller).
+         * Nothing is written to flash.
+         *
+         * @return size of DATA
+         */
+        uint16_t Default::calcFingerprints(uint32_t *fingerprints, uint16_t *sizes)
+        {
+            uint16_t dataSize = 0;
+            _writeTarget = WriteTarget::Fingerprint;
+            _fingerprinting = true;
+            for (uint8_t i = 0; i < openknx.modules.count; i++)
+            {
+                Module *module = openknx.modules.list[i];
+                const uint16_t moduleSize = module->flashSize();
+                if (moduleSize == 0)
+                    continue;
+
+                _fingerprint = moduleFingerprint(openknx.modules.ids[i], moduleSize, module->flashVersion());
+                _currentWriteAddress = 0;
+                _maxWriteAddress = moduleSize;
+#ifdef OPENKNX_FLASH_COMPRESSION
+                // only count the encoded size
+                _encoder.begin(nullptr);
+                _encoding = _compression;
+#endif
+                module->writeFlash();
+                writeFilldata();
+                fingerprints[i] = _fingerprint;
+                sizes[i] = moduleSize;
+#ifdef OPENKNX_FLASH_COMPRESSION
+                if (_encoding)
+                {
+                    const uint32_t encodedSize = _encoder.end();
+                    if (encodedSize < moduleSize)
+                        sizes[i] = encodedSize;
+
+                    _encoding = false;
+                }
+#endif
+
+                dataSize += sizes[i] + FLASH_DATA_MODULE_META_LEN;
+            }
+            _fingerprinting = false;
+            _writeTarget = WriteTarget::Flash;
+            return dataSize;
+        }
+
+        /**
+         * Size of DATA and of MOD_DATA (uncompressed) without a dry run
+         */
+        uint16_t Default::calcSizes(uint16_t *sizes)
+        {
+            uint16_t dataSize = 0;
+            for (uint8_t i = 0; i < openknx.modules.count; i++)
+            {
+                sizes[i] = openknx.modules.list[i]->flashSize();
+                if (sizes[i] > 0)
+                    dataSize += sizes[i] + FLASH_DATA_MODULE_META_LEN;
+            }
+
+            return dataSize;
+        }
+
+        /**
+         * Start of a module fingerprint: MOD_ID, MOD_SIZE (uncompressed) and MOD_VERSION like in MOD_META
+         */
+        uint32_t Default::moduleFingerprint(uint8_t moduleId, uint16_t size, uint8_t version)
+        {
+            const uint8_t meta[FLASH_DATA_MODULE_ID_LEN + FLASH_DATA_SIZE_LEN + FLASH_DATA_MODULE_VERSION_LEN] = {moduleId, (uint8_t)(size & 0xFF), (uint8_t)(size >> 8), version};
+            return calcFingerprint(FLASH_DATA_FINGERPRINT_INIT, meta, sizeof(meta));
+        }
+
+        bool Default::hasChanges(uint32_t *fingerprints, uint16_t dataSize)
+        {
+            // nothing valid to compare with or modules added/removed
+            if (!_activeSlotCurrent || dataSize != _activeDataSize)
+                return true;
+
+            for (uint8_t i = 0; i < openknx.modules.count; i++)
+            {
+                if (openknx.modules.list[i]->flashSize() == 0)
+                    continue;
+
+                if (!_records[i].stored || _records[i].fingerprint != fingerprints[i])
+                    return true;
+            }
+
+            return false;
+        }
+
+        int8_t Default::moduleIndex(uint8_t moduleId)
+        {
+            for (uint8_t i = 0; i < openknx.modules.count; i++)
+                if (openknx.modules.ids[i] == moduleId)
+                    return i;
+
+            return -1;
+        }
+
         void Default::save(bool force /* = false */)
+        {
+            // the dry run is only needed to skip unchanged data and for the size of compressed data,
+            // otherwise the fingerprints are calculated while writing (each module is serialized once)
+#ifdef OPENKNX_FLASH_COMPRESSION
+            saveModules(force, !force || _compression);
+#else
+            saveModules(force, !force);
+#endif
+        }
+
+        void Default::saveModules(bool force, bool dryRun)
         {
             openknx.common.skipLooptimeWarning();
 
-            _checksum = 0;
+            // complete a running async save first
+            while (_saveState != SaveState::Idle)
+                processSaveAsync();
+
             uint32_t start = millis();
 
             // table is not loaded (ets prog running) and save is not possible
             if (!knx.configured())
                 return;
 
-            // we have to ensure, that save is not called too often, because flash memory
-            // does not survive too many writes
-            if (!force && _lastWrite > 0 && !delayCheck(_lastWrite, FLASH_DATA_WRITE_LIMIT))
-                return;
-
             logBegin();
             logInfoP("Save data to flash%s", force ? " (force)" : "");
             logIndentUp();
-            logDebugP("Slot %i", nextSlot());
 
             // determine some values
-            uint16_t dataSize = 0;
-            for (uint8_t i = 0; i < openknx.modules.count; i++)
+            uint32_t fingerprints[OPENKNX_MAX_MODULES] = {};
+            uint16_t sizes[OPENKNX_MAX_MODULES] = {};
+            const uint16_t dataSize = dryRun ? calcFingerprints(fingerprints, sizes) : calcSizes(sizes);
+            const uint32_t serialized = delayTimerInit();
+
+            logTraceP("dataSize: %i", dataSize);
+
+            // would overwrite the previous slot or the key/value store
+            if ((uint32_t)dataSize + FLASH_DATA_META_LEN > slotSize())
             {
-                const uint16_t moduleSize = openknx.modules.list[i]->flashSize();
-                if (moduleSize == 0)
-                    continue;
+                logErrorP("Skip: Data with %i bytes does not fit into a slot with %i bytes (reduce OPENKNX_FLASH_SLOTS)", dataSize + FLASH_DATA_META_LEN, slotSize());
+                _lastFailure = serialized;
+                logIndentDown();
+                logEnd();
+                return;
+            }
 
-                dataSize += moduleSize +
-                            FLASH_DATA_MODULE_ID_LEN +
-                            FLASH_DATA_SIZE_LEN;
+            // skip programming and erasing, when all data is already stored in the active slot
+            if (!force && !hasChanges(fingerprints, dataSize))
+            {
+                _lastWrite = serialized;
+                _lastFailure = 0;
+                logInfoP("Skip: No changes since last save (%ims)", millis() - start);
+                logIndentDown();
+                logEnd();
+                return;
             }
 
-            logTraceP("dataSize: %i", dataSize);
+            logDebugP("Slot %i", nextSlot());
 
             // start point
             _currentWriteAddress = writeOffset() -
@@ -293,30 +705,131 @@ namespace OpenKNX
 
             logTraceP("startPosition: %i", _currentWriteAddress);
 
+            writeData(dataSize, sizes, fingerprints, !dryRun);
+
+            openknx.openknxFlash.commit();
+            logHexTraceP(openknx.openknxFlash.flashAddress() + writeOffset() - dataSize - FLASH_DATA_META_LEN, dataSize + FLASH_DATA_META_LEN);
+
+            _activeSlotCurrent = true;
+            _activeDataSize = dataSize;
+            _lastWrite = serialized;
+            _lastFailure = 0;
+
+            logInfoP("Save completed (%ims)", millis() - start);
+#ifdef OPENKNX_FLASH_TELEMETRY
+            openknx.flashTelemetry.recordSave(millis() - start);
+#endif
+
+#ifdef FLASH_DATA_MULTI_SLOT
+            // new active slot
+            _activeSlot = nextSlot();
+
+            // erase next slot
+            eraseSlot(nextSlot());
+#endif
+
+#ifdef OPENKNX_FLASH_POWERFAIL_IMAGE
+            // image was prepared for the previous slot
+            _imageChanged = true;
+            _imageRefreshed = 0;
+#endif
+
+            logIndentDown();
+            logEnd();
+        }
+
+        /**
+         * Write DATA and META for all modules to the current write target (starting at _currentWriteAddress).
+         * With fingerprints, unchanged modules are copied from the active slot and the records are updated.
+         */
+        void Default::writeData(uint16_t dataSize, uint16_t *sizes, uint32_t *fingerprints /* = nullptr */, bool fingerprint /* = false */)
+        {
+            _checksum = 0;
+
             for (uint8_t i = 0; i < openknx.modules.count; i++)
             {
                 // get data
                 Module *module = openknx.modules.list[i];
                 uint16_t moduleSize = module->flashSize();
                 uint8_t moduleId = openknx.modules.ids[i];
+                ModuleRecord &record = _records[i];
 
                 if (moduleSize == 0)
                     continue;
 
-                _maxWriteAddress = _currentWriteAddress +
-                                   FLASH_DATA_MODULE_ID_LEN +
-                                   FLASH_DATA_SIZE_LEN;
+                // size of MOD_DATA from dry run
+                const uint16_t size = sizes[i];
+                const bool compressed = size < moduleSize;
+
+                _maxWriteAddress = _currentWriteAddress + FLASH_DATA_MODULE_META_LEN;
 
                 // write header for module data
                 writeByte(moduleId);
-                writeWord(moduleSize);
+                writeWord(size);
+                writeByte(module->flashVersion());
+                writeByte(compressed ? FLASH_DATA_MODULE_COMPRESSED : 0);
 
                 // write the module data
                 _maxWriteAddress = _currentWriteAddress + moduleSize;
+                const uint32_t address = _currentWriteAddress;
+#ifdef OPENKNX_FLASH_TELEMETRY
+                const uint32_t start = micros();
+#endif
 
-                logDebugP("Save module %s (%i) with %i bytes", module->name().c_str(), moduleId, moduleSize);
-                module->writeFlash();
-                writeFilldata();
+                if (fingerprints != nullptr && !fingerprint && _activeSlotCurrent && record.stored && record.fingerprint == fingerprints[i] && record.size == size && nextSlot() != _activeSlot)
+                {
+                    // unchanged module data is copied from the active slot (not possible with a single slot)
+                    logDebugP("Copy unchanged module %s (%i) with %i bytes", module->name().c_str(), moduleId, size);
+                    write(openknx.openknxFlash.flashAddress() + record.address, size);
+                }
+#ifdef OPENKNX_FLASH_COMPRESSION
+                else if (compressed)
+                {
+                    logDebugP("Save module %s (%i) with %i bytes (compressed to %i bytes)", module->name().c_str(), moduleId, moduleSize, size);
+                    _encodedWriteAddress = address;
+                    _maxEncodedWriteAddress = address + size;
+                    _encoder.begin(encoderOutput);
+                    _encoding = true;
+                    module->writeFlash();
+                    writeFilldata();
+                    _encoder.end();
+                    _encoding = false;
+
+                    // module has written other data than in dry run
+                    if (_encodedWriteAddress != _maxEncodedWriteAddress)
+                    {
+                        logErrorP("Module data changed while saving");
+                        const uint8_t fill = FLASH_DATA_FILLBYTE;
+                        while (_encodedWriteAddress < _maxEncodedWriteAddress)
+                            writeOutput(_encodedWriteAddress, &fill, 1);
+                    }
+
+                    _currentWriteAddress = _encodedWriteAddress;
+                }
+#endif
+                else
+                {
+                    logDebugP("Save module %s (%i) with %i bytes", module->name().c_str(), moduleId, moduleSize);
+                    // fingerprint without dry run
+                    _fingerprinting = fingerprint;
+                    _fingerprint = moduleFingerprint(moduleId, moduleSize, module->flashVersion());
+                    module->writeFlash();
+                    writeFilldata();
+                    _fingerprinting = false;
+                    if (fingerprint)
+                        fingerprints[i] = _fingerprint;
+                }
+#ifdef OPENKNX_FLASH_TELEMETRY
+                openknx.flashTelemetry.recordSerialize(i, micros() - start);
+#endif
+
+                if (fingerprints != nullptr)
+                {
+                    record.fingerprint = fingerprints[i];
+                    record.address = address;
+                    record.size = size;
+                    record.stored = true;
+                }
             }
 
             // write magicword
@@ -334,30 +847,289 @@ namespace OpenKNX
             writeByte(nextVersion());
 
             // write checksum
-            writeWord(_checksum);
+            writeInt(_checksum);
 
             // block of metadata
             writeInt(FLASH_DATA_INIT);
+        }
 
-            openknx.openknxFlash.commit();
-            logHexTraceP(openknx.openknxFlash.flashAddress() + writeOffset() - dataSize - FLASH_DATA_META_LEN, dataSize + FLASH_DATA_META_LEN);
+        void Default::savePowerFail()
+        {
+            // table is not loaded (ets prog running) and save is not possible
+            if (!knx.configured())
+                return;
 
-            logInfoP("Save completed (%ims)", millis() - start);
+            // complete a running async save first
+            while (_saveState != SaveState::Idle)
+                processSaveAsync();
 
-#ifdef ARDUINO_ARCH_RP2040
-            // new active slot
-            _activeSlot = !_activeSlot;
+#ifdef OPENKNX_FLASH_POWERFAIL_IMAGE
+            // the image is only programmed into a pre-erased slot (no serialization in the hold-up time)
+            if (!_imageValid || _imageChanged || _imageSlot != nextSlot() || nextSlot() == _activeSlot || overlapsLegacyData(nextSlot()))
+            {
+                // no current image - write all modules without dry run (uncompressed)
+                logDebugP("Image outdated");
+                saveModules(true, false);
+                return;
+            }
 
-            // erase next slot
-            eraseSlot(nextSlot());
+            const uint32_t start = micros();
+            openknx.openknxFlash.write(writeOffset() - _imageSize, _image, _imageSize);
+            openknx.openknxFlash.commit();
+
+            const uint32_t duration = micros() - start;
+            _lastWrite = _imageRefreshed;
+            _lastFailure = 0;
+            _activeSlot = nextSlot();
+            // module data in image is not tracked, so the next save will write all modules again
+            _activeSlotCurrent = false;
+            // erase is done after a short power loss (in loop)
+            _imageValid = false;
+            _imageChanged = true;
+            _imageEraseNextSlot = true;
+            _imageRefreshed = 0;
+
+            logInfoP("Save image completed (%ius)", duration);
+    #ifdef OPENKNX_FLASH_TELEMETRY
+            openknx.flashTelemetry.recordSave(duration / 1000);
+    #endif
+#else
+            // no dry run in the hold-up time (uncompressed)
+            saveModules(true, false);
 #endif
+        }
+
+        void Default::moduleDataChanged()
+        {
+#ifdef OPENKNX_FLASH_POWERFAIL_IMAGE
+            _imageChanged = true;
+#endif
+        }
+
+        bool Default::saveAsync(void (*callback)() /* = nullptr */)
+        {
+            // table is not loaded (ets prog running) and save is not possible
+            if (!knx.configured() || _saveState != SaveState::Idle)
+                return false;
+
+            const uint32_t start = millis();
+
+            logBegin();
+            logInfoP("Save data to flash (async)");
+            logIndentUp();
+
+            // determine some values
+            uint32_t fingerprints[OPENKNX_MAX_MODULES] = {};
+            uint16_t sizes[OPENKNX_MAX_MODULES] = {};
+            const uint16_t dataSize = calcFingerprints(fingerprints, sizes);
+            const uint32_t serialized = delayTimerInit();
+
+            // would overwrite the previous slot or the key/value store (checked before the buffer is allocated)
+            if ((uint32_t)dataSize + FLASH_DATA_META_LEN > slotSize())
+            {
+                logErrorP("Skip: Data with %i bytes does not fit into a slot with %i bytes (reduce OPENKNX_FLASH_SLOTS)", dataSize + FLASH_DATA_META_LEN, slotSize());
+                _lastFailure = serialized;
+                logIndentDown();
+                logEnd();
+                return false;
+            }
+
+            // skip programming and erasing, when all data is already stored in the active slot
+            if (!hasChanges(fingerprints, dataSize))
+            {
+                _lastWrite = serialized;
+                _lastFailure = 0;
+                logInfoP("Skip: No changes since last save (%ims)", millis() - start);
+                logIndentDown();
+                logEnd();
+
+                if (callback != nullptr)
+                    callback();
+
+                return true;
+            }
 
+            logDebugP("Slot %i", nextSlot());
+
+            _saveDataSize = dataSize;
+            _saveStarted = start;
+            _saveSerialized = serialized;
+            _saveCallback = callback;
+            _saveEnd = writeOffset();
+            _saveOffset = _saveEnd - dataSize - FLASH_DATA_META_LEN;
+            _savePosition = _saveOffset;
+            _saveBuffer = new uint8_t[dataSize + FLASH_DATA_META_LEN];
+
+            // serialize all modules at once to get a consistent state
+            _writeTarget = WriteTarget::Buffer;
+            _writeBuffer = _saveBuffer;
+            _writeBufferOffset = _saveOffset;
+            _currentWriteAddress = _saveOffset;
+            writeData(dataSize, sizes, fingerprints);
+            _writeTarget = WriteTarget::Flash;
+
+            _saveState = SaveState::Program;
+
+            logDebugP("Serialized (%ims)", millis() - start);
             logIndentDown();
             logEnd();
+            return true;
+        }
+
+        bool Default::saving()
+        {
+            return _saveState != SaveState::Idle;
+        }
+
+        uint32_t Default::lastSave()
+        {
+            return _lastWrite;
+        }
+
+        uint32_t Default::lastFailure()
+        {
+            return _lastFailure;
+        }
+
+        /**
+         * Program or erase the next sector of a running async save
+         */
+        void Default::processSaveAsync()
+        {
+            const uint32_t sectorSize = openknx.openknxFlash.sectorSize();
+
+            // only up to the end of the current sector
+            uint32_t end = (_savePosition / sectorSize + 1) * sectorSize;
+            if (end > _saveEnd)
+                end = _saveEnd;
+
+            if (_saveState == SaveState::Program)
+                openknx.openknxFlash.write(_savePosition, _saveBuffer + (_savePosition - _saveOffset), end - _savePosition);
+            else
+                openknx.openknxFlash.write(_savePosition, 0xFF, end - _savePosition);
+
+            openknx.openknxFlash.commit();
+            _savePosition = end;
+
+            if (_savePosition < _saveEnd)
+                return;
+
+            if (_saveState == SaveState::Program)
+            {
+                delete[] _saveBuffer;
+                _saveBuffer = nullptr;
+
+                _activeSlotCurrent = true;
+                _activeDataSize = _saveDataSize;
+                _lastWrite = _saveSerialized;
+                _lastFailure = 0;
+
+#ifdef FLASH_DATA_MULTI_SLOT
+                // new active slot
+                _activeSlot = nextSlot();
+
+                // erase next slot (never the active slot with a single slot)
+                if (nextSlot() != _activeSlot)
+                {
+                    _saveState = SaveState::Erase;
+                    _savePosition = slotOffset(nextSlot()) - slotSize();
+                    _saveEnd = slotOffset(nextSlot());
+                    return;
+                }
+#endif
+            }
+
+            completeSaveAsync();
+        }
+
+        void Default::completeSaveAsync()
+        {
+            _saveState = SaveState::Idle;
+
+#ifdef OPENKNX_FLASH_POWERFAIL_IMAGE
+            // image was prepared for the previous slot
+            _imageChanged = true;
+            _imageRefreshed = 0;
+#endif
+
+            logInfoP("Save completed (async, %ims)", millis() - _saveStarted);
+#ifdef OPENKNX_FLASH_TELEMETRY
+            openknx.flashTelemetry.recordSave(millis() - _saveStarted);
+#endif
+
+            if (_saveCallback != nullptr)
+                _saveCallback();
+        }
+
+        void Default::loop()
+        {
+            if (_saveState != SaveState::Idle)
+            {
+                // max one sector operation per loop
+                if (openknx.common.freeLoopTime())
+                    processSaveAsync();
+
+                return;
+            }
+
+#ifdef OPENKNX_FLASH_POWERFAIL_IMAGE
+            // a save without erase was done (after power loss)
+            if (_imageEraseNextSlot)
+            {
+                eraseSlot(nextSlot());
+                _imageEraseNextSlot = false;
+                return;
+            }
+
+            // rebuild after changes (see moduleDataChanged), at most once per interval and only with free loop time
+            if (_imageChanged && delayCheck(_imageRefreshed, OPENKNX_FLASH_POWERFAIL_IMAGE_INTERVAL) && openknx.common.freeLoopTime())
+                refreshImage();
+#endif
         }
 
+#ifdef OPENKNX_FLASH_POWERFAIL_IMAGE
+        /**
+         * Serialize all modules into the ram image for the next slot (single pass, uncompressed)
+         */
+        void Default::refreshImage()
+        {
+            _imageRefreshed = delayTimerInit();
+            _imageChanged = false;
+            _imageValid = false;
+
+            uint16_t sizes[OPENKNX_MAX_MODULES] = {};
+            const uint16_t dataSize = calcSizes(sizes);
+            const uint16_t imageSize = dataSize + FLASH_DATA_META_LEN;
+            if (imageSize > slotSize())
+            {
+                logErrorP("Image with %i bytes does not fit into a slot", imageSize);
+                return;
+            }
+
+            if (_image == nullptr || imageSize != _imageSize)
+            {
+                delete[] _image;
+                _image = new uint8_t[imageSize];
+                _imageSize = imageSize;
+            }
+
+            _writeTarget = WriteTarget::Buffer;
+            _writeBuffer = _image;
+            _writeBufferOffset = writeOffset() - imageSize;
+            _currentWriteAddress = _writeBufferOffset;
+            writeData(dataSize, sizes);
+            _writeTarget = WriteTarget::Flash;
+            _imageSlot = nextSlot();
+            _imageValid = true;
+        }
+#endif
+
         uint8_t *Default::currentFlash()
         {
+            // decoded module data
+            if (_readBuffer != nullptr)
+                return _readBuffer + (_currentReadAddress - _readBufferOffset);
+
             return openknx.openknxFlash.flashAddress() + _currentReadAddress;
         }
 
@@ -371,13 +1143,38 @@ namespace OpenKNX
             return sum;
         }
 
-        bool Default::verifyChecksum(uint8_t *data, uint16_t size, uint16_t checksum)
+        uint32_t Default::calcFingerprint(uint32_t fingerprint, const uint8_t *data, uint16_t size)
+        {
+            return crc32(fingerprint, data, size);
+        }
+
+        /**
+         * CRC-32 of size times value (in chunks instead of byte by byte)
+         */
+        uint32_t Default::crc32Fill(uint32_t crc, uint8_t value, uint16_t size)
+        {
+            uint8_t fill[32];
+            memset(fill, value, MIN(size, sizeof(fill)));
+            while (size > 0)
+            {
+                const uint16_t part = MIN(size, sizeof(fill));
+                crc = crc32(crc, fill, part);
+                size -= part;
+            }
+
+            return crc;
+        }
+
+        bool Default::verifyChecksum(uint8_t format, uint8_t *data, uint16_t size, uint32_t checksum)
         {
-            // logInfoP("verifyChecksum %i == %i", checksum, calcChecksum(data, size));
-            return checksum == calcChecksum(data, size);
+            // format v1 used a simple sum
+            if (format == 1)
+                return checksum == calcChecksum(data, size);
+
+            return checksum == crc32(0, data, size);
         }
 
-        void Default::write(uint8_t *buffer, uint16_t size)
+        void Default::write(const uint8_t *buffer, uint16_t size)
         {
             if ((_currentWriteAddress + size) > _maxWriteAddress)
             {
@@ -385,10 +1182,26 @@ namespace OpenKNX
                 return;
             }
 
-            for (uint16_t i = 0; i < size; i++)
-                _checksum += buffer[i];
+            if (_fingerprinting)
+                _fingerprint = calcFingerprint(_fingerprint, buffer, size);
 
-            _currentWriteAddress = openknx.openknxFlash.write(_currentWriteAddress, buffer, size);
+#ifdef OPENKNX_FLASH_COMPRESSION
+            if (_encoding)
+            {
+                // the encoder writes to _encodedWriteAddress (or only counts in dry run)
+                _encoder.write(buffer, size);
+                _currentWriteAddress += size;
+                return;
+            }
+#endif
+
+            if (_writeTarget == WriteTarget::Fingerprint)
+            {
+                _currentWriteAddress += size;
+                return;
+            }
+
+            writeOutput(_currentWriteAddress, buffer, size);
         }
 
         void Default::write(uint8_t value, uint16_t size)
@@ -399,12 +1212,74 @@ namespace OpenKNX
                 return;
             }
 
-            for (uint16_t i = 0; i < size; i++)
-                _checksum += value;
+            if (_fingerprinting)
+                _fingerprint = crc32Fill(_fingerprint, value, size);
+
+#ifdef OPENKNX_FLASH_COMPRESSION
+            if (_encoding)
+            {
+                _encoder.write(value, size);
+                _currentWriteAddress += size;
+                return;
+            }
+#endif
+
+            if (_writeTarget == WriteTarget::Fingerprint)
+            {
+                _currentWriteAddress += size;
+                return;
+            }
+
+            _checksum = crc32Fill(_checksum, value, size);
+
+            if (_writeTarget == WriteTarget::Buffer)
+            {
+                memset(_writeBuffer + (_currentWriteAddress - _writeBufferOffset), value, size);
+                _currentWriteAddress += size;
+                return;
+            }
 
             _currentWriteAddress = openknx.openknxFlash.write(_currentWriteAddress, value, size);
         }
 
+        /**
+         * Write to flash or buffer (with checksum)
+         */
+        void Default::writeOutput(uint32_t &address, const uint8_t *data, uint16_t size)
+        {
+            _checksum = crc32(_checksum, data, size);
+
+            if (_writeTarget == WriteTarget::Buffer)
+            {
+                memcpy(_writeBuffer + (address - _writeBufferOffset), data, size);
+                address += size;
+                return;
+            }
+
+            address = openknx.openknxFlash.write(address, (uint8_t *)data, size);
+        }
+
+#ifdef OPENKNX_FLASH_COMPRESSION
+        /**
+         * Output of the encoder
+         */
+        void Default::encoderOutput(const uint8_t *data, uint16_t size)
+        {
+            openknx.flash.writeEncoded(data, size);
+        }
+
+        void Default::writeEncoded(const uint8_t *data, uint16_t size)
+        {
+            if (_encodedWriteAddress + size > _maxEncodedWriteAddress)
+            {
+                logErrorP("Module data changed while saving");
+                return;
+            }
+
+            writeOutput(_encodedWriteAddress, data, size);
+        }
+#endif
+
         void Default::writeByte(uint8_t value)
         {
             write((uint8_t *)&value);
@@ -443,26 +1318,28 @@ namespace OpenKNX
 
         uint8_t Default::readByte()
         {
-            _currentReadAddress += 1;
-            return openknx.openknxFlash.readByte(_currentReadAddress - 1);
+            return *read(1);
         }
 
         uint16_t Default::readWord()
         {
-            _currentReadAddress += 2;
-            return openknx.openknxFlash.readWord(_currentReadAddress - 2);
+            uint16_t value = 0;
+            memcpy(&value, read(2), 2);
+            return value;
         }
 
         uint32_t Default::readInt()
         {
-            _currentReadAddress += 4;
-            return openknx.openknxFlash.readInt(_currentReadAddress - 4);
+            uint32_t value = 0;
+            memcpy(&value, read(4), 4);
+            return value;
         }
 
         float Default::readFloat()
         {
-            _currentReadAddress += 4;
-            return openknx.openknxFlash.readFloat(_currentReadAddress - 4);
+            float value = 0;
+            memcpy(&value, read(4), 4);
+            return value;
         }
 
         uint16_t Default::firmwareVersion()
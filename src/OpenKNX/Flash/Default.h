@@ -1,8 +1,21 @@
 #pragma once
+#include "OpenKNX/Flash/Crc32.h"
 #include "OpenKNX/Flash/Driver.h"
+#include "OpenKNX/Flash/RunLength.h"
+#include "OpenKNX/defines.h"
+#include <cstring>
+#include <type_traits>
 
 #ifndef FLASH_DATA_WRITE_LIMIT
-    #define FLASH_DATA_WRITE_LIMIT 180000 // 3 Minutes delay
+    #define FLASH_DATA_WRITE_LIMIT 180000 // 3 Minutes delay for best-effort save requests (see SavePolicy)
+#endif
+
+#ifndef FLASH_DATA_SAVE_RETRY
+    #define FLASH_DATA_SAVE_RETRY 60000 // 1 Minute delay before requests of a failed save are retried (see SavePolicy)
+#endif
+
+#if defined(OPENKNX_FLASH_POWERFAIL_IMAGE) && !defined(OPENKNX_FLASH_POWERFAIL_IMAGE_INTERVAL)
+    #define OPENKNX_FLASH_POWERFAIL_IMAGE_INTERVAL 1000 // min. time between two rebuilds of the image
 #endif
 
 #define FLASH_DATA_FILLBYTE 0xFF
@@ -14,16 +27,25 @@
  * Aligned to end of (usable) flash, as we do want to maximize otherwhise
  * usable space and NOT use a fixed starting position.
  *
- * Definition of Data-Structure (Format v1):
+ * Slots:
+ * The flash storage is split into FLASH_DATA_SLOTS slots of equal size, used as ring.
+ * Every save is written to the (pre-erased) slot following the active slot, afterwards
+ * the next slot in the ring is erased. So all sectors of the storage are erased evenly
+ * and older data remain available as fallback until the ring wraps around.
+ * On load the valid slot with the newest VERSION is used.
+ * If no slot is valid, the slots of the layout before the ring (see FLASH_DATA_LEGACY_SLOTS) are checked,
+ * this data stays untouched until the first save has written it into the ring.
+ *
+ * Definition of Data-Structure (Format v4):
  * - Numeric values are given in big-endian byte-order
  * - Values are defined as unsigned integers of given size
  *   (as not explicitly defined otherwhise)
  *
  * Global Structure, Sizing and Layout:
  * > ......................................................... available flash storage --->| the_end
- * >                      |<- DATA[?] ->|<------------------- META[12] ------------------->|
+ * >                      |<- DATA[?] ->|<------------------- META[15] ------------------->|
  * >                      |<------- CHECKSUM_INPUT ------->|
- * > FLASH_STORAGE_DATA :=  DATA[$SIZE] ; APP[4] ; SIZE[2] ; VERSION[1] ; CHK[2] ; INIT[4] |
+ * > FLASH_STORAGE_DATA :=  DATA[$SIZE] ; APP[4] ; SIZE[2] ; VERSION[1] ; CHK[4] ; INIT[4] |
  * Note: Size is defined in [bytes]
  *
  * Overview:
@@ -32,9 +54,14 @@
  *   - APP  uint8_t[4]: device/firmware info
  *   - SIZE uint16_t  : size (and indirect position) definition for DATA
  *   - VERSION uint8_t: save a version (only when slot are using)
- *   - CHK  uint8_t[2]: checksum
+ *   - CHK  uint8_t[4]: checksum (CRC-32)
  *   - INIT uint8_t[4]: the magic word for format detection
  *
+ * Format v3 (still readable) only differs in MOD_META: no MOD_FLAGS (never compressed).
+ * Format v2 (still readable) additionally has no MOD_VERSION (read as version 0).
+ * Format v1 (still readable) additionally differs in CHK: uint8_t[2] with a 16 bit sum of all bytes (META[12]).
+ * Data in older formats is always rewritten on next save.
+ *
  * A more detailed description is following below on defines related to fields.
  */
 
@@ -60,19 +87,21 @@ uint16_t SIZE define the length and position of DATA:
 #define FLASH_DATA_SIZE_LEN 2
 
 /**
-uint16_t CHK contains a checksum over all bytes of CHECKSUM_INPUT
+uint32_t CHK contains a CRC-32 over all bytes of CHECKSUM_INPUT (calculated while writing)
 
 The checksum should detect partial writes, or partes of DATA overwritten.
+Format v1 used an uint16_t sum of all bytes, which does not detect e.g. swapped bytes.
 */
-#define FLASH_DATA_CHK_LEN 2
+#define FLASH_DATA_CHK_LEN 4
+#define FLASH_DATA_CHK_V1_LEN 2
 
 /**
 INIT contains the Magic-Word including a format version number.
 &INIT = (_startAddress + _flashSize) - FLASH_DATA_INIT_LEN
 The value is fixed for current implementation.
 >        |MAGIC_BYTES|  VERSION  |
-> INIT :=  'O' ; 'K' ; 'V' ; 0x01
-Which is expected as bytes-sequence: 4F 4B 56 01
+> INIT :=  'O' ; 'K' ; 'V' ; 0x04
+Which is expected as bytes-sequence: 4F 4B 56 04
 
 DATA *must* *not* be processed without an exact match of INIT!
 Othere values of INIT indicates:
@@ -82,7 +111,10 @@ b) data written with an incompatible structure
        There is the idea to increase version number in last byte in this case,
        but there is no guaranteed or definition yet.
 */
-#define FLASH_DATA_INIT 22432591 /* other endianness 1330337281 */
+#define FLASH_DATA_INIT 72764239 /* other endianness 1330337284 */
+#define FLASH_DATA_INIT_V3 55987023 /* other endianness 1330337283 */
+#define FLASH_DATA_INIT_V2 39209807 /* other endianness 1330337282 */
+#define FLASH_DATA_INIT_V1 22432591 /* other endianness 1330337281 */
 
 /**
 Intro for Identification (and possible versioning later).
@@ -91,12 +123,37 @@ Intro for Identification (and possible versioning later).
 #define FLASH_DATA_INIT_LEN 4
 
 /**
- * A version for dual write support (on SAMD disabled)
+ * A version for multi slot support (on ESP32 disabled)
+ * Incremented with every save, the slot with the newest version wins.
  */
 #define FLASH_DATA_VERSION 1
 
+/**
+ * Number of slots in the ring (only on RP2040 and SAMD, otherwhise a single slot is used)
+ * Each slot must be a multiple of the sector size (NVM row on SAMD), else a single slot is used.
+ */
+#if defined(ARDUINO_ARCH_RP2040) || defined(ARDUINO_ARCH_SAMD)
+    #define FLASH_DATA_MULTI_SLOT
+    #define FLASH_DATA_SLOTS OPENKNX_FLASH_SLOTS
+#else
+    #define FLASH_DATA_SLOTS 1
+#endif
+
+/**
+ * Slots of the layout before the ring (without key/value store at the start of the flash storage):
+ * RP2040 used two slots (A/B) in the halves and SAMD a single slot. They are addressed as slot
+ * FLASH_DATA_LEGACY_SLOT + i (only read, the first save writes into the ring).
+ */
+#if defined(ARDUINO_ARCH_RP2040)
+    #define FLASH_DATA_LEGACY_SLOTS 2
+#elif defined(ARDUINO_ARCH_SAMD)
+    #define FLASH_DATA_LEGACY_SLOTS 1
+#endif
+#define FLASH_DATA_LEGACY_SLOT 0x80
+
 /** Overall fixed-size of the non-module-data part */
 #define FLASH_DATA_META_LEN (FLASH_DATA_APP_LEN + FLASH_DATA_SIZE_LEN + FLASH_DATA_VERSION + FLASH_DATA_CHK_LEN + FLASH_DATA_INIT_LEN)
+#define FLASH_DATA_META_V1_LEN (FLASH_DATA_META_LEN - FLASH_DATA_CHK_LEN + FLASH_DATA_CHK_V1_LEN)
 
 //
 // ==== FLASH_STORAGE_DATA - DATA ====
@@ -112,8 +169,8 @@ Intro for Identification (and possible versioning later).
  *       but indirectly by datatype of SIZE and MOD_META
  *
  * Structure of single module data:
- * > MODULE	  := MOD_META[3] ; MOD_DATA[MOD_SIZE]
- * > MOD_META := MOD_ID[1] ; MOD_SIZE[2]
+ * > MODULE	  := MOD_META[5] ; MOD_DATA[MOD_SIZE]
+ * > MOD_META := MOD_ID[1] ; MOD_SIZE[2] ; MOD_VERSION[1] ; MOD_FLAGS[1]
  *
  * MOD_ID	:= uint8_t
  *   Identification of ModuleType as in knxprod.
@@ -123,6 +180,15 @@ Intro for Identification (and possible versioning later).
  *   Define the length of MOD_DATA and position of following MODULE-block:
  *   &(MODULE[i+1]) := &(MODULE[i]) + sizeof(MOD_META) + MOD_SIZE
  *
+ * MOD_VERSION := uint8_t
+ *   Schema version of MOD_DATA given by Module::flashVersion().
+ *   Data with another version is passed to Module::migrateFlash() on load.
+ *
+ * MOD_FLAGS := uint8_t
+ *   FLASH_DATA_MODULE_COMPRESSED: MOD_DATA is run-length encoded (see RunLength.h),
+ *   MOD_SIZE is the encoded size. The module gets the decoded data on load.
+ *   Used only with OPENKNX_FLASH_COMPRESSION and if the encoded data is smaller.
+ *
  * MOD_DATA	:= uint8_t[$MOD_SIZE}
  *   Content ist defined by the module (referenced in MOD_ID) only.
  *   Module must not write >MOD_SIZE bytes
@@ -137,11 +203,23 @@ Intro for Identification (and possible versioning later).
  */
 
 #define FLASH_DATA_MODULE_ID_LEN 1
+#define FLASH_DATA_MODULE_VERSION_LEN 1
+#define FLASH_DATA_MODULE_FLAGS_LEN 1
+#define FLASH_DATA_MODULE_META_LEN (FLASH_DATA_MODULE_ID_LEN + FLASH_DATA_SIZE_LEN + FLASH_DATA_MODULE_VERSION_LEN + FLASH_DATA_MODULE_FLAGS_LEN)
+#define FLASH_DATA_MODULE_COMPRESSED 0x01
+
+/*
+ * Fingerprint (CRC-32) over MOD_ID, MOD_SIZE, MOD_VERSION and MOD_DATA of a single module (always uncompressed).
+ * Only kept in RAM to detect unchanged module data, it is not part of the format.
+ */
+#define FLASH_DATA_FINGERPRINT_INIT 0
 
 // TODO check using #define FLASH_DATA_MODULE_SIZE_LEN FLASH_DATA_SIZE_LEN
 
 namespace OpenKNX
 {
+    class Module;
+
     namespace Flash
     {
         /**
@@ -152,11 +230,48 @@ namespace OpenKNX
          * Scope/Exclusion: ETS-Parametrization is NOT part of this data. Only e.g. values of Logic-Module,
          *                  or calibration-data of sensors which should be saved on power loss.
          */
+        /**
+         * State of the module data stored in the active slot
+         */
+        struct ModuleRecord
+        {
+            // fingerprint over uncompressed module data
+            uint32_t fingerprint = 0;
+            // relative address of MOD_DATA
+            uint32_t address = 0;
+            // MOD_SIZE in flash
+            uint16_t size = 0;
+            // data of module is stored in active slot
+            bool stored = false;
+            // module was restored from flash
+            bool loaded = false;
+        };
+
+        enum class WriteTarget
+        {
+            Flash,
+            Fingerprint,
+            Buffer
+        };
+
+        enum class SaveState
+        {
+            Idle,
+            Program,
+            Erase
+        };
+
         class Default
         {
           public:
             void init();
 
+            /**
+             * Processes a running async save with max one sector operation (program or erase) per call.
+             * With OPENKNX_FLASH_POWERFAIL_IMAGE it also rebuilds the ram image of the module data after changes.
+             */
+            void loop();
+
             /**
              * TODO extend documentation
              *
@@ -168,7 +283,7 @@ namespace OpenKNX
              * 1d) read version
              * 1e) validate checksum
              * 2)  check is a valid slot available
-             * 3)  select slot with higher version
+             * 3)  select valid slot with newest version
              * 4)  load module data
              * 5)  empty load (init) for the remaining modules
              */
@@ -178,9 +293,13 @@ namespace OpenKNX
              * TODO extend documentation
              *
              * Steps for writing:
-             * 1) get required data-size for all modules
+             * 1) get required data-size and fingerprint for all modules (dry run of writeFlash)
+             * 1a) skip saving, when no module data has changed since last save/load
+             *     with force there is no dry run (without compression): all modules are written and the fingerprints
+             *     are calculated while writing
              * 2) calculate overall data-size and start-position
              * 3) write DATA: data and fill unused requested space (for all modules)
+             *    unchanged modules are copied from the active slot without calling writeFlash
              * 4) write APP
              * 5) write SIZE
              * 6) write VERSION
@@ -188,7 +307,64 @@ namespace OpenKNX
              * 8) write INIT
              */
             void save(bool force = false);
-            void write(uint8_t *buffer, uint16_t size = 1);
+
+            /**
+             * Save in context of a power failure (SAVE-Interrupt)
+             *
+             * With OPENKNX_FLASH_POWERFAIL_IMAGE the serialized data (incl. META) is already prepared in ram
+             * and only needs to be programmed into the pre-erased slot, no module is serialized. If the image is
+             * outdated (changes since the last rebuild, see moduleDataChanged) or no pre-erased slot is available,
+             * it falls back to a normal write. Otherwise same as save(true), but always without dry run
+             * (and compression), so each module is serialized only once.
+             */
+            void savePowerFail();
+
+            /**
+             * Module data has changed (called by Module::requestSave). With OPENKNX_FLASH_POWERFAIL_IMAGE the ram image
+             * is rebuilt in loop(), so modules have to request a save for each change to use the image on power failure.
+             */
+            void moduleDataChanged();
+
+#ifdef OPENKNX_FLASH_SIMULATION
+            /**
+             * Power loss test on simulated flash (see OPENKNX_FLASH_SIMULATION), cuts each save at every operation
+             */
+            void torture(uint32_t passes);
+    #ifdef OPENKNX_FLASH_COMPRESSION
+            /**
+             * Compares programmed bytes and save latency with and without compression (simulated flash)
+             */
+            void benchmark();
+    #endif
+#endif
+
+            /**
+             * Non-blocking save: all modules are serialized into ram at once (like save()), but programming
+             * and erasing is done sector by sector in loop() while free loop time is available.
+             * A running async save is completed by a call of save() or savePowerFail().
+             *
+             * @param callback is called after the data is stored (or when the save was skipped because of no changes)
+             * @return false if an async save is already running or saving is not possible (e.g. data does not fit into a slot)
+             */
+            bool saveAsync(void (*callback)() = nullptr);
+
+            /**
+             * @return true while an async save is running
+             */
+            bool saving();
+
+            /**
+             * @return time (millis) when the module data of the last successful save (or of a save skipped without changes)
+             * was serialized, 0 if not saved since startup
+             */
+            uint32_t lastSave();
+
+            /**
+             * @return time (millis) of the last failed save (data does not fit into a slot), 0 if the last save was successful
+             */
+            uint32_t lastFailure();
+            void write(const uint8_t *buffer, uint16_t size = 1);
+            void write(uint8_t *buffer, uint16_t size = 1) { write((const uint8_t *)buffer, size); }
             void write(uint8_t value, uint16_t size);
             void writeByte(uint8_t value);
             void writeWord(uint16_t value);
@@ -201,32 +377,184 @@ namespace OpenKNX
             float readFloat();
             uint16_t firmwareVersion();
 
+            /**
+             * Size of the given types in flash. Can be used in Module::flashSize(), so the reserved size always
+             * matches the data written by writeValues() with the same types.
+             */
+            template <typename T>
+            static constexpr uint32_t sizeOf()
+            {
+                return sizeof(T);
+            }
+
+            template <typename T, typename U, typename... R>
+            static constexpr uint32_t sizeOf()
+            {
+                return sizeof(T) + sizeOf<U, R...>();
+            }
+
+            /**
+             * Writes a struct or a list of fields (trivially copyable) in native byte-order with a single write.
+             * Example: openknx.flash.writeValues(_state) or openknx.flash.writeValues(_counter, _lastValue);
+             * A single value is written directly, a list of fields is packed on the stack first (use a struct for large data).
+             */
+            template <typename T>
+            void writeValues(const T &value)
+            {
+                static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable types can be written");
+                static_assert(sizeof(T) <= 0xFFFF, "module data is limited to 64K");
+                write((const uint8_t *)&value, sizeof(T));
+            }
+
+            template <typename T, typename U, typename... R>
+            void writeValues(const T &value, const U &next, const R &...rest)
+            {
+                static_assert(sizeOf<T, U, R...>() <= 0xFFFF, "module data is limited to 64K");
+                uint8_t buffer[sizeOf<T, U, R...>()];
+                pack(buffer, value, next, rest...);
+                write(buffer, sizeof(buffer));
+            }
+
+            /**
+             * Reads a struct or a list of fields written by writeValues() with a single copy.
+             */
+            template <typename... T>
+            void readValues(T &...values)
+            {
+                unpack(read(sizeOf<T...>()), values...);
+            }
+
+            /**
+             * Maps a struct written by writeValues() directly onto the flash (no copy).
+             * Returns nullptr (and keeps the read position) if the data is not aligned for T,
+             * use readValues() in this case or declare T as packed.
+             */
+            template <typename T>
+            const T *view()
+            {
+                static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable types can be mapped");
+                if ((uintptr_t)currentFlash() % alignof(T))
+                    return nullptr;
+
+                return (const T *)read(sizeof(T));
+            }
+
           private:
-            bool *loadedModules = nullptr;
-            bool _activeSlot = false; // false = A & true = B
+            ModuleRecord _records[OPENKNX_MAX_MODULES];
+            uint8_t _activeSlot = 0;
+            uint32_t _legacyDataStart = 0; // relative flash address of the data in a legacy slot (while active)
+            uint8_t _slots = FLASH_DATA_SLOTS;
+            bool _activeSlotCurrent = false; // active slot contains data of current firmware
+            WriteTarget _writeTarget = WriteTarget::Flash;
+            uint32_t _fingerprint = 0;
+            bool _fingerprinting = false;
+            uint8_t *_writeBuffer = nullptr;
+            uint32_t _writeBufferOffset = 0; // relative flash address of _writeBuffer[0]
+            SaveState _saveState = SaveState::Idle;
+            uint8_t *_saveBuffer = nullptr;
+            uint32_t _saveOffset = 0; // relative flash address of _saveBuffer[0]
+            uint32_t _savePosition = 0;
+            uint32_t _saveEnd = 0;
+            uint32_t _saveStarted = 0;
+            uint32_t _saveSerialized = 0;
+            uint16_t _saveDataSize = 0;
+            void (*_saveCallback)() = nullptr;
+            void processSaveAsync();
+            void completeSaveAsync();
+#ifdef OPENKNX_FLASH_POWERFAIL_IMAGE
+            uint8_t *_image = nullptr;
+            uint16_t _imageSize = 0;
+            uint8_t _imageSlot = 0;
+            bool _imageValid = false;
+            bool _imageEraseNextSlot = false;
+            bool _imageChanged = true;
+            uint32_t _imageRefreshed = 0;
+            void refreshImage();
+#endif
+            uint16_t _activeDataSize = 0;
             uint32_t _lastWrite = 0;
+            uint32_t _lastFailure = 0;
             uint16_t _lastFirmwareNumber = 0;
             uint16_t _lastFirmwareVersion = 0;
-            uint16_t _checksum = 0;
+            uint32_t _checksum = 0;
             uint32_t _currentWriteAddress = 0;
             uint32_t _currentReadAddress = 0;
             uint32_t _maxWriteAddress = 0;
+            uint8_t *_readBuffer = nullptr;
+            uint32_t _readBufferOffset = 0; // relative flash address of _readBuffer[0]
+#ifdef OPENKNX_FLASH_COMPRESSION
+            RunLengthEncoder _encoder;
+            bool _encoding = false;
+            bool _compression = true;
+            uint32_t _encodedWriteAddress = 0;
+            uint32_t _maxEncodedWriteAddress = 0;
+            static void encoderOutput(const uint8_t *data, uint16_t size);
+            void writeEncoded(const uint8_t *data, uint16_t size);
+#endif
+            void saveModules(bool force, bool dryRun);
             void writeFilldata();
+            void writeData(uint16_t dataSize, uint16_t *sizes, uint32_t *fingerprints = nullptr, bool fingerprint = false);
+            void writeOutput(uint32_t &address, const uint8_t *data, uint16_t size);
+            uint16_t calcFingerprints(uint32_t *fingerprints, uint16_t *sizes);
+            uint16_t calcSizes(uint16_t *sizes);
+            uint32_t moduleFingerprint(uint8_t moduleId, uint16_t size, uint8_t version);
+            bool hasChanges(uint32_t *fingerprints, uint16_t dataSize);
+            int8_t moduleIndex(uint8_t moduleId);
             void loadModuleData();
             void initUnloadedModules();
-            bool validateSlot(bool slot);
-            void eraseSlot(bool slot);
+            bool validateSlot(uint8_t slot);
+            bool selectSlot();
+            bool selectLegacySlot();
+            bool overlapsLegacyData(uint8_t slot);
+            void eraseSlot(uint8_t slot);
+            void initSlots();
             uint8_t nextVersion();
-            uint8_t slotVersion(bool slot);
-            uint16_t slotOffset(bool slot);
-            uint16_t slotSize();
-            bool nextSlot();
+            bool isNewerVersion(uint8_t version, uint8_t reference);
+            uint8_t slotVersion(uint8_t slot);
+            uint32_t slotOffset(uint8_t slot);
+            uint32_t slotSize();
+            uint32_t legacySlotSize();
+            uint8_t nextSlot();
             uint32_t readOffset();
             uint32_t writeOffset();
             uint8_t *currentFlash();
+            uint8_t slotFormat(uint8_t slot);
+            uint8_t metaLength(uint8_t format);
+            uint8_t moduleMetaLength(uint8_t format);
+            void restoreModule(Module *module, const uint8_t *data, uint16_t size, uint8_t version);
             uint16_t calcChecksum(uint8_t *data, uint16_t size);
-            bool verifyChecksum(uint8_t *data, uint16_t size, uint16_t checksum);
-            std::string logPrefix();
+            uint32_t calcFingerprint(uint32_t fingerprint, const uint8_t *data, uint16_t size);
+            uint32_t crc32Fill(uint32_t crc, uint8_t value, uint16_t size);
+            bool verifyChecksum(uint8_t format, uint8_t *data, uint16_t size, uint32_t checksum);
+            const char *logPrefix();
+
+            template <typename T>
+            static void pack(uint8_t *buffer, const T &value)
+            {
+                static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable types can be written");
+                memcpy(buffer, &value, sizeof(T));
+            }
+
+            template <typename T, typename U, typename... R>
+            static void pack(uint8_t *buffer, const T &value, const U &next, const R &...rest)
+            {
+                pack(buffer, value);
+                pack(buffer + sizeof(T), next, rest...);
+            }
+
+            template <typename T>
+            static void unpack(const uint8_t *buffer, T &value)
+            {
+                static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable types can be read");
+                memcpy(&value, buffer, sizeof(T));
+            }
+
+            template <typename T, typename U, typename... R>
+            static void unpack(const uint8_t *buffer, T &value, U &next, R &...rest)
+            {
+                unpack(buffer, value);
+                unpack(buffer + sizeof(T), next, rest...);
+            }
         };
     } // namespace Flash
 } // namespace OpenKNX
\ No newline at end of file
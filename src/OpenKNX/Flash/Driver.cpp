@@ -25,6 +25,7 @@ namespace OpenKNX
 #endif
         {
             _id = id;
+            _logPrefix.set("FlashDriver", _id.c_str());
 
 #ifdef ARDUINO_ARCH_ESP32
             // ESP32
@@ -50,7 +51,15 @@ namespace OpenKNX
             _offset = offset;
             _size = size;
 
-    #if defined(ARDUINO_ARCH_SAMD)
+    #if defined(OPENKNX_FLASH_SIMULATION)
+            // simulated flash in ram (erased)
+            _sectorSize = OPENKNX_FLASH_SIMULATION_SECTOR_SIZE;
+            _pageSize = OPENKNX_FLASH_SIMULATION_PAGE_SIZE;
+            _endFree = _offset + _size;
+            _simulation = new uint8_t[_size];
+            memset(_simulation, 0xFF, _size);
+            logDebugP("simulated flash at 0x%08X with %i size", _offset, _size);
+    #elif defined(ARDUINO_ARCH_SAMD)
             // SAMD21
             const uint32_t pageSizes[] = {8, 16, 32, 64, 128, 256, 512, 1024};
             _sectorSize = pageSizes[NVMCTRL->PARAM.bit.PSZ] * 4;
@@ -63,15 +72,23 @@ namespace OpenKNX
             _pageSize = FLASH_PAGE_SIZE;
             _endFree = (uint32_t)(&_FS_start) - 0x10000000lu;
     #endif
+    #ifndef OPENKNX_FLASH_SIMULATION
             logDebugP("flash at 0x%08X with %i size", _offset, _size);
+    #endif
 #endif
 
             validateParameters();
+
+            // known erased sectors (unknown after start)
+            _erasedSectors = new uint32_t[(_size / _sectorSize + 31) / 32]();
         }
 
-        std::string Driver::logPrefix()
+        const char *Driver::logPrefix()
         {
-            return openknx.logger.buildPrefix("FlashDriver", _id);
+            if (_logPrefix.empty())
+                _logPrefix.set("FlashDriver", _id.c_str());
+
+            return _logPrefix;
         }
 
         void Driver::validateParameters()
@@ -80,6 +97,8 @@ namespace OpenKNX
                 openknx.hardware.fatalError(FATAL_FLASH_PARAMETERS, "Flash: Size unaligned");
             if (_offset % _sectorSize)
                 openknx.hardware.fatalError(FATAL_FLASH_PARAMETERS, "Flash: Offset unaligned");
+            if (_sectorSize / _pageSize > 32)
+                openknx.hardware.fatalError(FATAL_FLASH_PARAMETERS, "Flash: Too many pages per sector");
             if (_size > _endFree)
                 openknx.hardware.fatalError(FATAL_FLASH_PARAMETERS, "Flash: End behind free flash");
 #ifdef ARDUINO_ARCH_ESP32
@@ -95,7 +114,9 @@ namespace OpenKNX
 
         uint8_t *Driver::flashAddress()
         {
-#if defined(ARDUINO_ARCH_SAMD)
+#if defined(OPENKNX_FLASH_SIMULATION)
+            return _simulation;
+#elif defined(ARDUINO_ARCH_SAMD)
             return (uint8_t *)_offset;
 #elif defined(ARDUINO_ARCH_ESP32)
             return _mmap;
@@ -136,131 +157,294 @@ namespace OpenKNX
 
         bool Driver::needEraseSector(uint16_t sector)
         {
-            for (size_t i = 0; i < _sectorSize; i++)
-                if ((flashAddress() + sector * _sectorSize)[i] != 0xFF)
+            // erased by this driver and not programmed since
+            if (knownErased(sector))
+                return false;
+
+            const uint32_t *flash = (const uint32_t *)(flashAddress() + sector * _sectorSize);
+            for (uint16_t i = 0; i < _sectorSize / 4; i++)
+                if (flash[i] != 0xFFFFFFFF)
                     return true;
 
+            markErased(sector, true);
             return false;
         }
 
-        bool Driver::needWriteSector()
+        /**
+         * Compares buffer with flash word by word in a single pass (size and both addresses must be word aligned).
+         *
+         * @param changedPages bitmap of pages with differences to flash
+         * @param usedPages bitmap of pages with data (not erased) in buffer - to program after an erase
+         * @return true if an erase is needed (a bit changes from 0 to 1)
+         */
+        bool Driver::compare(const uint8_t *buffer, const uint8_t *flash, uint16_t size, uint32_t &changedPages, uint32_t &usedPages)
         {
-            return memcmp(_buffer, flashAddress() + _bufferSector * _sectorSize, _sectorSize);
+            const uint32_t *bufferWords = (const uint32_t *)buffer;
+            const uint32_t *flashWords = (const uint32_t *)flash;
+            const uint16_t pageWords = _pageSize / 4;
+            bool erase = false;
+
+            changedPages = 0;
+            usedPages = 0;
+            for (uint16_t i = 0; i < size / 4; i++)
+            {
+                const uint32_t bufferWord = bufferWords[i];
+                const uint32_t flashWord = flashWords[i];
+                const uint32_t page = 1u << (i / pageWords);
+
+                if (bufferWord != 0xFFFFFFFF)
+                    usedPages |= page;
+
+                if (bufferWord != flashWord)
+                {
+                    changedPages |= page;
+                    if (bufferWord & ~flashWord)
+                        erase = true;
+                }
+            }
+
+            return erase;
         }
 
-        bool Driver::needEraseForBuffer()
+        bool Driver::knownErased(uint16_t sector)
         {
-            uint8_t flashByte;
-            uint8_t bufferByte;
-            for (size_t i = 0; i < _sectorSize; i++)
-            {
-                flashByte = (flashAddress() + _bufferSector * _sectorSize)[i];
-                bufferByte = _buffer[i];
+            return _erasedSectors != nullptr && (_erasedSectors[sector / 32] & (1u << (sector % 32)));
+        }
 
-                if (bufferByte != flashByte && (bufferByte & ~flashByte))
-                    return true;
+        void Driver::markErased(uint16_t sector, bool erased)
+        {
+            if (_erasedSectors == nullptr)
+                return;
+
+            if (erased)
+                _erasedSectors[sector / 32] |= (1u << (sector % 32));
+            else
+                _erasedSectors[sector / 32] &= ~(1u << (sector % 32));
+        }
+
+        /**
+         * Select the buffer of sector (loaded from flash if not cached yet)
+         */
+        void Driver::loadSector(uint16_t sector)
+        {
+            SectorBuffer *entry = findSector(sector);
+            if (entry == nullptr)
+            {
+                // load specific sector
+                logTraceP("load buffer for sector %i", sector);
+                logIndentUp();
+
+                if (_cache == nullptr)
+                    _cache = new SectorBuffer[_cacheSize];
+
+                // use a free entry or the least recently used
+                entry = &_cache[0];
+                for (uint8_t i = 0; i < _cacheSize && entry->data != nullptr; i++)
+                    if (_cache[i].data == nullptr || _cache[i].lastUse < entry->lastUse)
+                        entry = &_cache[i];
+
+                // cache is full - write before load
+                if (entry->data != nullptr)
+                    flushSector(*entry);
+
+                // initalize buffer (released after commit)
+                entry->data = new uint8_t[_sectorSize];
+                entry->sector = sector;
+                memcpy(entry->data, flashAddress() + sector * _sectorSize, _sectorSize);
+
+                // the cache is the only owner of a sector - take over a loaded page of it
+                if (_pageBufferLoaded && sectorOfRelativeAddress(_pageBufferPage * _pageSize) == sector)
+                {
+                    memcpy(entry->data + (_pageBufferPage * _pageSize) % _sectorSize, _pageBuffer, _pageSize);
+                    _pageBufferLoaded = false;
+                }
+                logIndentDown();
             }
 
-            return false;
+            entry->lastUse = ++_cacheUse;
+            _buffer = entry->data;
+            _bufferSector = entry->sector;
         }
 
-        void Driver::loadSector(uint16_t sector, bool force /* = false */)
+        SectorBuffer *Driver::findSector(uint16_t sector)
         {
-            // skip - already loaded and not force
-            if (!force && _buffer != nullptr && sector == _bufferSector)
-                return;
+            if (_cache == nullptr)
+                return nullptr;
 
-            // load specific sector
-            logTraceP("load buffer for sector %i", sector);
-            logIndentUp();
+            for (uint8_t i = 0; i < _cacheSize; i++)
+                if (_cache[i].data != nullptr && _cache[i].sector == sector)
+                    return &_cache[i];
 
-            // an other sector is loaded - commit before load
-            if (_buffer != nullptr && sector != _bufferSector)
-                commit();
+            return nullptr;
+        }
 
-            // initalize buffer for first time
-            if (_buffer == nullptr)
-                _buffer = new uint8_t[_sectorSize];
+        void Driver::flushSector(SectorBuffer &entry)
+        {
+            _buffer = entry.data;
+            _bufferSector = entry.sector;
+            writeSector();
 
-            _bufferSector = sector;
-            memcpy(_buffer, flashAddress() + _bufferSector * _sectorSize, _sectorSize);
-            logIndentDown();
+            delete[] entry.data;
+            entry.data = nullptr;
+            _buffer = nullptr;
         }
 
-        void Driver::commit()
+        void Driver::cacheSectors(uint8_t count)
         {
-            // no sector loaded
-            if (_buffer == nullptr)
-                return;
+            commit();
+            delete[] _cache;
+            _cache = nullptr;
+            _cacheSize = count > 0 ? count : 1;
+        }
 
-            logTraceP("commit");
-            logIndentUp();
-            writeSector();
-            logIndentDown();
+        uint32_t Driver::eraseCount()
+        {
+            return _eraseCount;
         }
 
-        uint32_t Driver::write(uint32_t relativeAddress, uint8_t value, uint32_t size /* = 1 */)
+        uint32_t Driver::programCount()
+        {
+            return _programCount;
+        }
+
+        void Driver::resetStatistic()
         {
-            if (size <= 0)
-                return relativeAddress;
+            _eraseCount = 0;
+            _programCount = 0;
+        }
 
-            uint16_t sector = sectorOfRelativeAddress(relativeAddress);
+        void Driver::loadPage(uint32_t page)
+        {
+            // skip - already loaded
+            if (_pageBufferLoaded && page == _pageBufferPage)
+                return;
 
-            // load buffer if needed
-            loadSector(sector);
+            // an other page is loaded - write before load
+            writePage();
 
-            // position in loaded buffer
-            uint16_t bufferPosition = relativeAddress % _sectorSize;
+            // the previous page moved its sector into the cache, which contains this page then
+            if (findSector(sectorOfRelativeAddress(page * _pageSize)) != nullptr)
+                return;
 
-            // determine available large within the sector
-            uint16_t writeMaxSize = _sectorSize - bufferPosition;
+            // initalize buffer for first time
+            if (_pageBuffer == nullptr)
+                _pageBuffer = new uint8_t[_pageSize];
 
-            // determine size outside the sector
-            uint16_t overheadSize = (writeMaxSize < size) ? size - writeMaxSize : 0;
+            _pageBufferPage = page;
+            _pageBufferLoaded = true;
+            memcpy(_pageBuffer, flashAddress() + _pageBufferPage * _pageSize, _pageSize);
+        }
 
-            // determine how much must be stored within the sector.
-            uint16_t writeSize = (writeMaxSize < size) ? writeMaxSize : size;
+        /**
+         * Returns the position in the buffer for the given address and limits size to the end of this buffer.
+         * Writes go into the sector buffer, if the sector is in read-modify-write. Otherwise the page buffer is used.
+         * A sector in the cache never has a loaded page buffer, so each byte has exactly one buffer.
+         */
+        uint8_t *Driver::prepareWrite(uint32_t relativeAddress, uint32_t &size)
+        {
+            const uint16_t sector = sectorOfRelativeAddress(relativeAddress);
+            SectorBuffer *entry = findSector(sector);
+            if (entry == nullptr)
+            {
+                // writing the previous page may move the sector into the cache
+                loadPage(relativeAddress / _pageSize);
+                entry = findSector(sector);
+            }
 
-            // write date to current buffer
-            memset(_buffer + bufferPosition, value, writeSize);
+            if (entry != nullptr)
+            {
+                entry->lastUse = ++_cacheUse;
 
-            // write overhead in next sector
-            if (overheadSize > 0)
-                return write(relativeAddress + writeSize, value, overheadSize);
+                const uint16_t bufferPosition = relativeAddress % _sectorSize;
+                if (size > (uint32_t)(_sectorSize - bufferPosition))
+                    size = _sectorSize - bufferPosition;
 
-            return relativeAddress + size;
+                return entry->data + bufferPosition;
+            }
+
+            const uint16_t bufferPosition = relativeAddress % _pageSize;
+            if (size > (uint32_t)(_pageSize - bufferPosition))
+                size = _pageSize - bufferPosition;
+
+            return _pageBuffer + bufferPosition;
         }
 
-        uint32_t Driver::write(uint32_t relativeAddress, uint8_t *buffer, uint32_t size /* = 1 */)
+        /**
+         * Program the page buffer directly if possible. Otherwise the page is taken over into a sector buffer
+         * and the whole sector is written with erase on commit (read-modify-write).
+         */
+        void Driver::writePage()
         {
-            if (size <= 0)
-                return relativeAddress;
+            if (!_pageBufferLoaded)
+                return;
+
+            _pageBufferLoaded = false;
+
+            const uint32_t relativeAddress = _pageBufferPage * _pageSize;
+
+            uint32_t changedPages = 0;
+            uint32_t usedPages = 0;
+            const bool erase = compare(_pageBuffer, flashAddress() + relativeAddress, _pageSize, changedPages, usedPages);
+
+            if (!changedPages)
+                return;
 
-            uint16_t sector = sectorOfRelativeAddress(relativeAddress);
+            if (!erase)
+            {
+                programRange(relativeAddress, _pageBuffer, _pageSize);
+                return;
+            }
 
-            // load buffer if needed
-            loadSector(sector);
+            logTraceP("page %i needs erase", _pageBufferPage);
+            loadSector(sectorOfRelativeAddress(relativeAddress));
+            memcpy(_buffer + relativeAddress % _sectorSize, _pageBuffer, _pageSize);
+        }
 
-            // position in loaded buffer
-            uint16_t bufferPosition = relativeAddress % _sectorSize;
+        void Driver::commit()
+        {
+            // nothing loaded
+            if (_cache == nullptr && !_pageBufferLoaded)
+                return;
 
-            // determine available large within the sector
-            uint16_t writeMaxSize = _sectorSize - bufferPosition;
+            logTraceP("commit");
+            logIndentUp();
+            writePage();
 
-            // determine size outside the sector
-            uint16_t overheadSize = (writeMaxSize < size) ? size - writeMaxSize : 0;
+            if (_cache != nullptr)
+                for (uint8_t i = 0; i < _cacheSize; i++)
+                    if (_cache[i].data != nullptr)
+                        flushSector(_cache[i]);
 
-            // determine how much must be stored within the sector.
-            uint16_t writeSize = (writeMaxSize < size) ? writeMaxSize : size;
+            logIndentDown();
+        }
 
-            // write date to current buffer
-            memcpy(_buffer + bufferPosition, buffer, writeSize);
+        uint32_t Driver::write(uint32_t relativeAddress, uint8_t value, uint32_t size /* = 1 */)
+        {
+            while (size > 0)
+            {
+                uint32_t writeSize = size;
+                uint8_t *target = prepareWrite(relativeAddress, writeSize);
+                memset(target, value, writeSize);
+                relativeAddress += writeSize;
+                size -= writeSize;
+            }
+
+            return relativeAddress;
+        }
 
-            // write overhead in next sector
-            if (overheadSize > 0)
-                return write(relativeAddress + writeSize, buffer + writeSize, overheadSize);
+        uint32_t Driver::write(uint32_t relativeAddress, uint8_t *buffer, uint32_t size /* = 1 */)
+        {
+            while (size > 0)
+            {
+                uint32_t writeSize = size;
+                uint8_t *target = prepareWrite(relativeAddress, writeSize);
+                memcpy(target, buffer, writeSize);
+                buffer += writeSize;
+                relativeAddress += writeSize;
+                size -= writeSize;
+            }
 
-            return relativeAddress + size;
+            return relativeAddress;
         }
 
         uint32_t Driver::writeByte(uint32_t relativeAddress, uint8_t value)
@@ -326,8 +510,19 @@ namespace OpenKNX
             }
 
             logTraceP("erase sector %i", sector);
+            _eraseCount++;
+#ifdef OPENKNX_FLASH_TELEMETRY
+            const uint32_t start = micros();
+#endif
+
+#if defined(OPENKNX_FLASH_SIMULATION)
+            // erase is done completely or not at all
+            if (simulateOperation(1) == 0)
+                return;
 
-#if defined(ARDUINO_ARCH_SAMD)
+            memset(_simulation + sector * _sectorSize, 0xFF, _sectorSize);
+            _simulatedMicros += OPENKNX_FLASH_SIMULATION_ERASE_US;
+#elif defined(ARDUINO_ARCH_SAMD)
             NVMCTRL->ADDR.reg = ((uint32_t)_offset + (sector * _sectorSize)) / 2;
             NVMCTRL->CTRLA.reg = NVMCTRL_CTRLA_CMDEX_KEY | NVMCTRL_CTRLA_CMD_ER;
             while (!NVMCTRL->INTFLAG.bit.READY)
@@ -341,37 +536,47 @@ namespace OpenKNX
             flash_range_erase((intptr_t)(_offset + (sector * _sectorSize)), _sectorSize);
             rp2040.resumeOtherCore();
             interrupts();
+#endif
+            markErased(sector, true);
+
+#ifdef OPENKNX_FLASH_TELEMETRY
+    #if defined(OPENKNX_FLASH_SIMULATION)
+            openknx.flashTelemetry.recordErase(this, sector, OPENKNX_FLASH_SIMULATION_ERASE_US);
+            (void)start;
+    #else
+            openknx.flashTelemetry.recordErase(this, sector, micros() - start);
+    #endif
 #endif
         }
 
-        void Driver::writeSector()
+        /**
+         * Program data into flash (page aligned, only bits from 1 to 0 are changed)
+         */
+        void Driver::programRange(uint32_t relativeAddress, const uint8_t *data, uint32_t size)
         {
-            if (!needWriteSector())
-            {
-                logTraceP("skip write sector, because no changes");
-                return;
-            }
+            logTraceP("program 0x%04X (%i bytes)", relativeAddress, size);
+            _programCount++;
 
-            if (needEraseForBuffer())
-            {
-                eraseSector(_bufferSector);
-            }
+            // sector(s) are no longer erased
+            for (uint32_t address = relativeAddress; address < relativeAddress + size; address += _sectorSize)
+                markErased(sectorOfRelativeAddress(address), false);
 
-            logTraceP("write sector %i", _bufferSector);
-            // logHexTraceP(_buffer, _sectorSize);
+#if defined(OPENKNX_FLASH_SIMULATION)
+            // programming can only clear bits, stops after any byte on power cut
+            const uint32_t programmed = simulateOperation(size);
+            for (uint32_t i = 0; i < programmed; i++)
+                _simulation[relativeAddress + i] &= data[i];
 
-#if defined(ARDUINO_ARCH_SAMD)
-            // logHexTraceP(_buffer, _sectorSize);
-            volatile uint32_t *src_addr = (volatile uint32_t *)_buffer;
-            volatile uint32_t *dst_addr = (volatile uint32_t *)(flashAddress() + (_bufferSector * _sectorSize));
+            _simulatedMicros += ((size + _pageSize - 1) / _pageSize) * OPENKNX_FLASH_SIMULATION_PROGRAM_US;
+#elif defined(ARDUINO_ARCH_SAMD)
+            volatile uint32_t *src_addr = (volatile uint32_t *)data;
+            volatile uint32_t *dst_addr = (volatile uint32_t *)(flashAddress() + relativeAddress);
 
             // Disable automatic page write
             NVMCTRL->CTRLB.bit.MANW = 1;
 
-            uint16_t size = _sectorSize / 4;
-
             // Do writes in pages
-            while (size)
+            for (uint32_t position = 0; position < size; position += _pageSize)
             {
                 // Execute "PBC" Page Buffer Clear
                 NVMCTRL->CTRLA.reg = NVMCTRL_CTRLA_CMDEX_KEY | NVMCTRL_CTRLA_CMD_PBC;
@@ -380,12 +585,11 @@ namespace OpenKNX
                 }
 
                 // Fill page buffer
-                for (uint16_t i = 0; i < (_sectorSize / 16) && size; i++)
+                for (uint16_t i = 0; i < (_pageSize / 4); i++)
                 {
                     *dst_addr = *src_addr;
                     src_addr++;
                     dst_addr++;
-                    size--;
                 }
 
                 // Execute "WP" Write Page
@@ -395,57 +599,181 @@ namespace OpenKNX
                 }
             }
 #elif defined(ARDUINO_ARCH_ESP32)
-            // write smaller _pageSize to reduze write time
-            uint32_t currentPosition = 0;
-            uint32_t currentSize = 0;
-            while (currentPosition < _sectorSize)
+            spi_flash_write((size_t)(_offset + relativeAddress), data, size);
+#elif defined(ARDUINO_ARCH_RP2040)
+            noInterrupts();
+            rp2040.idleOtherCore();
+            flash_range_program((intptr_t)(_offset + relativeAddress), data, size);
+            rp2040.resumeOtherCore();
+            interrupts();
+#endif
+        }
+
+#ifdef OPENKNX_FLASH_SIMULATION
+        /**
+         * Consumes budget for an operation with size bytes
+         * @return number of bytes which are done before power is lost
+         */
+        uint32_t Driver::simulateOperation(uint32_t size)
+        {
+            if (_simulationPowerLost)
+                return 0;
+
+            // no power cut planned
+            if (_simulationBudget == UINT32_MAX)
             {
-                while (memcmp(_buffer + currentPosition + currentSize, flashAddress() + (_bufferSector * _sectorSize) + currentPosition + currentSize, _pageSize))
-                {
-                    currentSize += _pageSize;
+                _simulatedUnits += size;
+                return size;
+            }
+
+            if (size >= _simulationBudget)
+            {
+                size = _simulationBudget;
+                _simulationPowerLost = true;
+            }
+
+            _simulationBudget -= size;
+            _simulatedUnits += size;
+            return size;
+        }
 
-                    // last
-                    if (currentPosition + currentSize == _sectorSize)
-                        break;
+        void Driver::simulatePowerCut(uint32_t budget)
+        {
+            _simulationBudget = budget;
+            _simulationPowerLost = (budget == 0);
+        }
+
+        bool Driver::simulatedPowerLost()
+        {
+            return _simulationPowerLost;
+        }
+
+        void Driver::simulatePowerOn()
+        {
+            // content of ram is lost
+            _pageBufferLoaded = false;
+            if (_cache != nullptr)
+                for (uint8_t i = 0; i < _cacheSize; i++)
+                {
+                    delete[] _cache[i].data;
+                    _cache[i].data = nullptr;
                 }
 
-                // Changes Found
-                if (currentSize > 0)
-                    spi_flash_write((size_t)(_offset + (_bufferSector * _sectorSize) + currentPosition), _buffer + currentPosition, currentSize);
-                // flash_range_program((intptr_t)(_offset + (_bufferSector * _sectorSize) + currentPosition), _buffer + currentPosition, currentSize);
+            _buffer = nullptr;
+            memset(_erasedSectors, 0, ((_size / _sectorSize + 31) / 32) * sizeof(uint32_t));
 
-                currentPosition += currentSize + _pageSize;
-                currentSize = 0;
-            }
+            _simulationBudget = UINT32_MAX;
+            _simulationPowerLost = false;
+        }
 
-#elif defined(ARDUINO_ARCH_RP2040)
-            noInterrupts();
-            rp2040.idleOtherCore();
+        uint32_t Driver::simulatedMicros()
+        {
+            return _simulatedMicros;
+        }
+
+        uint32_t Driver::simulatedUnits()
+        {
+            return _simulatedUnits;
+        }
+
+        /**
+         * Random writes (single bytes, ranges and fills, also into programmed space) are compared with a model in ram
+         * after each commit. The content of the simulated flash is restored afterwards.
+         */
+        uint32_t Driver::simulateWrites(uint32_t rounds, uint8_t cache)
+        {
+            commit();
+            cacheSectors(cache);
+
+            uint8_t *backup = new uint8_t[_size];
+            uint8_t *model = new uint8_t[_size];
+            memcpy(backup, flashAddress(), _size);
+            memcpy(model, backup, _size);
 
-            // write smaller _pageSize to reduze write time
-            uint32_t currentPosition = 0;
-            uint32_t currentSize = 0;
-            while (currentPosition < _sectorSize)
+            uint8_t data[64];
+            uint32_t wrong = 0;
+            for (uint32_t round = 0; round < rounds; round++)
             {
-                while (memcmp(_buffer + currentPosition + currentSize, flashAddress() + (_bufferSector * _sectorSize) + currentPosition + currentSize, _pageSize))
+                const uint32_t size = random(1, sizeof(data) + 1);
+                const uint32_t address = random(0, _size - size + 1);
+                if (random(0, 4) == 0)
                 {
-                    currentSize += _pageSize;
+                    const uint8_t value = random(0, 256);
+                    write(address, value, size);
+                    memset(model + address, value, size);
+                }
+                else
+                {
+                    for (uint32_t i = 0; i < size; i++)
+                        data[i] = random(0, 256);
 
-                    // last
-                    if (currentPosition + currentSize == _sectorSize)
-                        break;
+                    write(address, data, size);
+                    memcpy(model + address, data, size);
                 }
 
-                // Changes Found
-                if (currentSize > 0)
-                    flash_range_program((intptr_t)(_offset + (_bufferSector * _sectorSize) + currentPosition), _buffer + currentPosition, currentSize);
+                if (round % 20 == 19 || round == rounds - 1)
+                {
+                    commit();
+                    for (uint32_t i = 0; i < _size; i++)
+                        if (flashAddress()[i] != model[i])
+                            wrong++;
 
-                currentPosition += currentSize + _pageSize;
-                currentSize = 0;
+                    // continue with the real content
+                    memcpy(model, flashAddress(), _size);
+                }
             }
-            rp2040.resumeOtherCore();
-            interrupts();
+
+            logInfoP("%i writes with %i cached sectors: %i wrong bytes", rounds, cache, wrong);
+
+            write(0, backup, _size);
+            commit();
+            cacheSectors(1);
+            delete[] backup;
+            delete[] model;
+            return wrong;
+        }
 #endif
+
+        void Driver::writeSector()
+        {
+            // single pass: differences per page and need of erase
+            uint32_t changedPages = 0;
+            uint32_t usedPages = 0;
+            const bool erase = compare(_buffer, flashAddress() + _bufferSector * _sectorSize, _sectorSize, changedPages, usedPages);
+
+            if (!changedPages)
+            {
+                logTraceP("skip write sector, because no changes");
+                return;
+            }
+
+            if (erase)
+            {
+                eraseSector(_bufferSector);
+
+                // after erase all pages with data have to be written
+                changedPages = usedPages;
+            }
+
+            logTraceP("write sector %i", _bufferSector);
+
+            // program continuous ranges of changed pages
+            const uint16_t pages = _sectorSize / _pageSize;
+            uint16_t page = 0;
+            while (page < pages)
+            {
+                if (!(changedPages & (1u << page)))
+                {
+                    page++;
+                    continue;
+                }
+
+                const uint16_t first = page;
+                while (page < pages && (changedPages & (1u << page)))
+                    page++;
+
+                programRange(_bufferSector * _sectorSize + first * _pageSize, _buffer + first * _pageSize, (page - first) * _pageSize);
+            }
         }
     } // namespace Flash
 } // namespace OpenKNX
\ No newline at end of file
@@ -1,15 +1,45 @@
 #pragma once
+#include "OpenKNX/Log/Logger.h"
 #include <Arduino.h>
 #include <string>
 
+#ifdef OPENKNX_FLASH_SIMULATION
+    #ifdef ARDUINO_ARCH_ESP32
+        #error "OPENKNX_FLASH_SIMULATION is not supported on ESP32"
+    #endif
+    #ifndef OPENKNX_FLASH_SIMULATION_SECTOR_SIZE
+        #define OPENKNX_FLASH_SIMULATION_SECTOR_SIZE 4096
+    #endif
+    #ifndef OPENKNX_FLASH_SIMULATION_PAGE_SIZE
+        #define OPENKNX_FLASH_SIMULATION_PAGE_SIZE 256
+    #endif
+    #ifndef OPENKNX_FLASH_SIMULATION_ERASE_US
+        #define OPENKNX_FLASH_SIMULATION_ERASE_US 45000 // sector erase
+    #endif
+    #ifndef OPENKNX_FLASH_SIMULATION_PROGRAM_US
+        #define OPENKNX_FLASH_SIMULATION_PROGRAM_US 700 // page program
+    #endif
+#endif
+
 namespace OpenKNX
 {
     namespace Flash
     {
+        /**
+         * Sector in read-modify-write (cache entry)
+         */
+        struct SectorBuffer
+        {
+            uint8_t *data = nullptr;
+            uint16_t sector = 0;
+            uint32_t lastUse = 0;
+        };
+
         class Driver
         {
           protected:
             std::string _id = "Unnamed";
+            Log::Prefix _logPrefix;
 
             uint32_t _offset = 0;
             uint32_t _size = 0;
@@ -18,21 +48,54 @@ namespace OpenKNX
             uint16_t _sectorSize = 0;
             uint16_t _pageSize = 0;
 
+            // cache of sector buffers for read-modify-write (only allocated while needed)
+            SectorBuffer *_cache = nullptr;
+            uint8_t _cacheSize = 1;
+            uint32_t _cacheUse = 0;
+
+            // selected sector buffer
             uint8_t *_buffer = nullptr;
             uint16_t _bufferSector = 0;
+
+            // statistic
+            uint32_t _eraseCount = 0;
+            uint32_t _programCount = 0;
+
+            // page buffer for direct programming of (pre-)erased space
+            uint8_t *_pageBuffer = nullptr;
+            uint32_t _pageBufferPage = 0;
+            bool _pageBufferLoaded = false;
 #ifdef ARDUINO_ARCH_ESP32
             uint8_t *_mmap = nullptr;
 #endif
+#ifdef OPENKNX_FLASH_SIMULATION
+            uint8_t *_simulation = nullptr;
+            uint32_t _simulatedMicros = 0;
+            uint32_t _simulatedUnits = 0;
+            uint32_t _simulationBudget = UINT32_MAX;
+            bool _simulationPowerLost = false;
+            uint32_t simulateOperation(uint32_t size);
+#endif
+
+            // bitmap of sectors known as erased
+            uint32_t *_erasedSectors = nullptr;
 
             void writeSector();
-            bool needWriteSector();
-            bool needEraseForBuffer();
+            void writePage();
+            void programRange(uint32_t relativeAddress, const uint8_t *data, uint32_t size);
+            bool compare(const uint8_t *buffer, const uint8_t *flash, uint16_t size, uint32_t &changedPages, uint32_t &usedPages);
             bool needEraseSector(uint16_t sector = 0);
+            bool knownErased(uint16_t sector);
+            void markErased(uint16_t sector, bool erased);
             uint16_t sectorOfRelativeAddress(uint32_t relativeAddress);
 
             void validateParameters();
 
-            void loadSector(uint16_t sector, bool force = false);
+            void loadSector(uint16_t sector);
+            SectorBuffer *findSector(uint16_t sector);
+            void flushSector(SectorBuffer &entry);
+            void loadPage(uint32_t page);
+            uint8_t *prepareWrite(uint32_t relativeAddress, uint32_t &size);
 
           public:
 #ifdef ARDUINO_ARCH_ESP32
@@ -40,12 +103,46 @@ namespace OpenKNX
 #else
             void init(std::string id, uint32_t offset, uint32_t size);
 #endif
-            std::string logPrefix();
+            const char *logPrefix();
 
             void eraseSector(uint16_t sector = 0);
             uint8_t *flashAddress();
 
             void commit();
+
+            /**
+             * Number of sectors kept in read-modify-write until commit (LRU, least recently used is written first).
+             * Allows to combine writes into alternating sectors (e.g. tables during ETS programming).
+             */
+            void cacheSectors(uint8_t count);
+
+            uint32_t eraseCount();
+            uint32_t programCount();
+            void resetStatistic();
+
+#ifdef OPENKNX_FLASH_SIMULATION
+            /**
+             * Power is lost after budget bytes (programmed byte or erased sector) - all further operations are ignored
+             */
+            void simulatePowerCut(uint32_t budget);
+            bool simulatedPowerLost();
+            /**
+             * Power returns: all buffers (ram) are lost
+             */
+            void simulatePowerOn();
+            /**
+             * Sum of the modeled latency of all erase and program operations
+             */
+            uint32_t simulatedMicros();
+            /**
+             * Sum of all programmed bytes and erased sectors
+             */
+            uint32_t simulatedUnits();
+            /**
+             * Random writes checked against a model in ram (content is restored), returns the number of wrong bytes
+             */
+            uint32_t simulateWrites(uint32_t rounds, uint8_t cache = 1);
+#endif
             uint32_t size();
             uint32_t startFree();
             uint32_t endFree();
@@ -0,0 +1,289 @@
+#include "OpenKNX/Flash/KeyValue.h"
+#include "OpenKNX/Facade.h"
+#include "OpenKNX/Flash/Crc32.h"
+
+namespace OpenKNX
+{
+    namespace Flash
+    {
+        const char *KeyValue::logPrefix()
+        {
+            return "Flash<KeyValue>";
+        }
+
+        void KeyValue::init()
+        {
+#if OPENKNX_FLASH_KV_SIZE > 0
+            logDebugP("Init key/value store");
+            logIndentUp();
+
+            if (bankSize() % openknx.openknxFlash.sectorSize())
+            {
+                logErrorP("OPENKNX_FLASH_KV_SIZE must be a multiple of two sectors");
+                logIndentDown();
+                return;
+            }
+
+            uint32_t generation0 = 0;
+            uint32_t generation1 = 0;
+            const bool valid0 = validateBank(0, generation0);
+            const bool valid1 = validateBank(1, generation1);
+
+            if (!valid0 && !valid1)
+            {
+                // initialize empty store in bank 0
+                logDebugP("No data found");
+                _bank = 1;
+                _generation = 0;
+                _entryCount = 0;
+                compact();
+            }
+            else
+            {
+                _bank = (valid1 && (!valid0 || generation1 > generation0)) ? 1 : 0;
+                _generation = _bank ? generation1 : generation0;
+                scanBank();
+            }
+
+            _ready = true;
+            logDebugP("Bank %i (generation %i) with %i keys, %i/%i bytes used", _bank, _generation, _entryCount, _writePosition, bankSize());
+            logIndentDown();
+#endif
+        }
+
+        uint32_t KeyValue::bankSize()
+        {
+            return OPENKNX_FLASH_KV_SIZE / 2;
+        }
+
+        uint32_t KeyValue::bankOffset(uint8_t bank)
+        {
+            return bank * bankSize();
+        }
+
+        uint32_t KeyValue::used()
+        {
+            return _writePosition;
+        }
+
+        uint32_t KeyValue::available()
+        {
+            return bankSize();
+        }
+
+        bool KeyValue::validateBank(uint8_t bank, uint32_t &generation)
+        {
+            if (openknx.openknxFlash.readInt(bankOffset(bank)) != FLASH_KV_MAGIC)
+                return false;
+
+            generation = openknx.openknxFlash.readInt(bankOffset(bank) + 4);
+            return true;
+        }
+
+        /**
+         * Build index of active bank and determine the write position
+         */
+        void KeyValue::scanBank()
+        {
+            const uint8_t *bank = openknx.openknxFlash.flashAddress() + bankOffset(_bank);
+            uint32_t position = FLASH_KV_HEADER_LEN;
+            _entryCount = 0;
+
+            while (position + FLASH_KV_RECORD_HEADER_LEN <= bankSize() && bank[position] != FLASH_KV_FREE)
+            {
+                if (!validateRecord(position))
+                {
+                    // unknown state behind this record - next write will start a compaction
+                    logErrorP("Invalid record at %i", position);
+                    position = bankSize();
+                    break;
+                }
+
+                const uint8_t moduleId = bank[position];
+                const uint8_t key = bank[position + 1];
+                const uint8_t size = bank[position + 2];
+                const int16_t index = findEntry(moduleId, key);
+
+                if (size == 0)
+                {
+                    // removed
+                    if (index >= 0)
+                        _entries[index] = _entries[--_entryCount];
+                }
+                else if (index >= 0)
+                {
+                    _entries[index].size = size;
+                    _entries[index].position = position;
+                }
+                else if (_entryCount < OPENKNX_FLASH_KV_ENTRIES)
+                {
+                    _entries[_entryCount].moduleId = moduleId;
+                    _entries[_entryCount].key = key;
+                    _entries[_entryCount].size = size;
+                    _entries[_entryCount].position = position;
+                    _entryCount++;
+                }
+                else
+                {
+                    logErrorP("Too many keys (OPENKNX_FLASH_KV_ENTRIES)");
+                }
+
+                position += FLASH_KV_RECORD_HEADER_LEN + size;
+            }
+
+            _writePosition = position;
+        }
+
+        bool KeyValue::validateRecord(uint32_t position)
+        {
+            const uint8_t *record = openknx.openknxFlash.flashAddress() + bankOffset(_bank) + position;
+            const uint8_t size = record[2];
+            if (position + FLASH_KV_RECORD_HEADER_LEN + size > bankSize())
+                return false;
+
+            const uint16_t crc = record[3] | (record[4] << 8);
+            return crc == calcCrc(record[0], record[1], record + FLASH_KV_RECORD_HEADER_LEN, size);
+        }
+
+        uint16_t KeyValue::calcCrc(uint8_t moduleId, uint8_t key, const uint8_t *data, uint8_t size)
+        {
+            const uint8_t header[3] = {moduleId, key, size};
+            return crc32(crc32(0, header, 3), data, size) & 0xFFFF;
+        }
+
+        int16_t KeyValue::findEntry(uint8_t moduleId, uint8_t key)
+        {
+            for (uint8_t i = 0; i < _entryCount; i++)
+                if (_entries[i].moduleId == moduleId && _entries[i].key == key)
+                    return i;
+
+            return -1;
+        }
+
+        bool KeyValue::write(uint8_t moduleId, uint8_t key, const uint8_t *data, uint8_t size)
+        {
+            if (!_ready || moduleId == FLASH_KV_FREE || size == 0)
+                return false;
+
+            const int16_t index = findEntry(moduleId, key);
+
+            // skip unchanged value
+            if (index >= 0 && _entries[index].size == size &&
+                !memcmp(openknx.openknxFlash.flashAddress() + bankOffset(_bank) + _entries[index].position + FLASH_KV_RECORD_HEADER_LEN, data, size))
+                return true;
+
+            if (index < 0 && _entryCount >= OPENKNX_FLASH_KV_ENTRIES)
+            {
+                logErrorP("Too many keys (OPENKNX_FLASH_KV_ENTRIES)");
+                return false;
+            }
+
+            return append(moduleId, key, data, size);
+        }
+
+        uint8_t KeyValue::read(uint8_t moduleId, uint8_t key, uint8_t *data, uint8_t size)
+        {
+            const int16_t index = findEntry(moduleId, key);
+            if (!_ready || index < 0)
+                return 0;
+
+            const KeyValueEntry &entry = _entries[index];
+            memcpy(data, openknx.openknxFlash.flashAddress() + bankOffset(_bank) + entry.position + FLASH_KV_RECORD_HEADER_LEN, entry.size < size ? entry.size : size);
+            return entry.size;
+        }
+
+        bool KeyValue::remove(uint8_t moduleId, uint8_t key)
+        {
+            if (!_ready)
+                return false;
+
+            if (findEntry(moduleId, key) < 0)
+                return true;
+
+            return append(moduleId, key, nullptr, 0);
+        }
+
+        bool KeyValue::append(uint8_t moduleId, uint8_t key, const uint8_t *data, uint8_t size)
+        {
+            const uint32_t recordSize = FLASH_KV_RECORD_HEADER_LEN + size;
+
+            // bank is full - copy current values into the other bank
+            if (_writePosition + recordSize > bankSize())
+                compact();
+
+            if (_writePosition + recordSize > bankSize())
+            {
+                logErrorP("No space left for %i bytes", recordSize);
+                return false;
+            }
+
+            const uint16_t crc = calcCrc(moduleId, key, data, size);
+            uint8_t header[FLASH_KV_RECORD_HEADER_LEN] = {moduleId, key, size, (uint8_t)(crc & 0xFF), (uint8_t)(crc >> 8)};
+            const uint32_t address = bankOffset(_bank) + _writePosition;
+            openknx.openknxFlash.write(address, header, FLASH_KV_RECORD_HEADER_LEN);
+            openknx.openknxFlash.write(address + FLASH_KV_RECORD_HEADER_LEN, (uint8_t *)data, size);
+            openknx.openknxFlash.commit();
+
+            // update index
+            const int16_t index = findEntry(moduleId, key);
+            if (size == 0)
+            {
+                if (index >= 0)
+                    _entries[index] = _entries[--_entryCount];
+            }
+            else
+            {
+                KeyValueEntry &entry = _entries[index >= 0 ? index : _entryCount++];
+                entry.moduleId = moduleId;
+                entry.key = key;
+                entry.size = size;
+                entry.position = _writePosition;
+            }
+
+            _writePosition += recordSize;
+            return true;
+        }
+
+        /**
+         * Copy all current records into the other bank and activate it
+         */
+        bool KeyValue::compact()
+        {
+            Driver &flash = openknx.openknxFlash;
+            const uint8_t target = _bank ? 0 : 1;
+            const uint32_t sourceOffset = bankOffset(_bank);
+            const uint32_t targetOffset = bankOffset(target);
+
+            const uint32_t start = millis();
+            logDebugP("Compaction into bank %i", target);
+
+            // erase
+            flash.write(targetOffset, 0xFF, bankSize());
+            flash.commit();
+
+            // records
+            uint32_t position = FLASH_KV_HEADER_LEN;
+            for (uint8_t i = 0; i < _entryCount; i++)
+            {
+                KeyValueEntry &entry = _entries[i];
+                const uint32_t recordSize = FLASH_KV_RECORD_HEADER_LEN + entry.size;
+                flash.write(targetOffset + position, flash.flashAddress() + sourceOffset + entry.position, recordSize);
+                entry.position = position;
+                position += recordSize;
+            }
+            flash.commit();
+
+            // header at last - marks the bank as complete
+            flash.writeInt(targetOffset, FLASH_KV_MAGIC);
+            flash.writeInt(targetOffset + 4, _generation + 1);
+            flash.commit();
+
+            _bank = target;
+            _generation++;
+            _writePosition = position;
+
+            logInfoP("Compaction completed (%ims)", millis() - start);
+            return true;
+        }
+    } // namespace Flash
+} // namespace OpenKNX
@@ -0,0 +1,94 @@
+#pragma once
+#include "OpenKNX/Flash/Driver.h"
+#include "OpenKNX/defines.h"
+
+/*
+ * Append-only key/value store at the start of the OpenKNX flash (OPENKNX_FLASH_KV_SIZE).
+ *
+ * Small values (e.g. counters) of a module can be updated by appending a record, without
+ * rewriting the data of all modules (see Flash::Default). The newest record per key wins.
+ *
+ * The region is split into two banks. The active bank is filled with records, when it is full
+ * all current values are copied into the other bank (compaction) and the banks are switched.
+ *
+ * Structure of a bank:
+ * > BANK   := HEADER[8] ; RECORD* ; free (0xFF)
+ * > HEADER := MAGIC[4] ; GENERATION[4]
+ * > RECORD := MODULE_ID[1] ; KEY[1] ; SIZE[1] ; CRC[2] ; DATA[SIZE]
+ *
+ * HEADER is written after all records of a compaction, so a bank with valid MAGIC is complete.
+ * The valid bank with the highest GENERATION is active.
+ * CRC contains the lower 16 bits of the CRC-32 over MODULE_ID, KEY, SIZE and DATA.
+ * A record with SIZE 0 removes the key. MODULE_ID 0xFF marks free space.
+ * An invalid record (partial write) marks the bank as full, so the next write starts a compaction.
+ */
+#define FLASH_KV_MAGIC 1447775055 /* 'O' 'K' 'K' 'V' */
+#define FLASH_KV_HEADER_LEN 8
+#define FLASH_KV_RECORD_HEADER_LEN 5
+#define FLASH_KV_FREE 0xFF
+
+namespace OpenKNX
+{
+    namespace Flash
+    {
+        struct KeyValueEntry
+        {
+            uint8_t moduleId = 0;
+            uint8_t key = 0;
+            uint8_t size = 0;
+            // position of record (relative to bank)
+            uint16_t position = 0;
+        };
+
+        class KeyValue
+        {
+          public:
+            /**
+             * Builds the index of the active bank
+             */
+            void init();
+
+            /**
+             * Stores value of key for module. Identical values are not written again.
+             * @return false if the store is not available or full
+             */
+            bool write(uint8_t moduleId, uint8_t key, const uint8_t *data, uint8_t size);
+
+            /**
+             * Reads value of key for module (max size bytes)
+             * @return size of stored value or 0 if key is not stored
+             */
+            uint8_t read(uint8_t moduleId, uint8_t key, uint8_t *data, uint8_t size);
+
+            /**
+             * Removes key of module
+             */
+            bool remove(uint8_t moduleId, uint8_t key);
+
+            /**
+             * Bytes used by records in active bank / available per bank
+             */
+            uint32_t used();
+            uint32_t available();
+
+          private:
+            bool _ready = false;
+            uint8_t _bank = 0;
+            uint32_t _generation = 0;
+            uint32_t _writePosition = 0;
+            uint8_t _entryCount = 0;
+            KeyValueEntry _entries[OPENKNX_FLASH_KV_ENTRIES];
+
+            uint32_t bankSize();
+            uint32_t bankOffset(uint8_t bank);
+            bool validateBank(uint8_t bank, uint32_t &generation);
+            void scanBank();
+            bool validateRecord(uint32_t position);
+            int16_t findEntry(uint8_t moduleId, uint8_t key);
+            bool append(uint8_t moduleId, uint8_t key, const uint8_t *data, uint8_t size);
+            bool compact();
+            uint16_t calcCrc(uint8_t moduleId, uint8_t key, const uint8_t *data, uint8_t size);
+            const char *logPrefix();
+        };
+    } // namespace Flash
+} // namespace OpenKNX
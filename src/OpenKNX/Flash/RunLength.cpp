@@ -0,0 +1,119 @@
+#include "OpenKNX/Flash/RunLength.h"
+
+namespace OpenKNX
+{
+    namespace Flash
+    {
+        void RunLengthEncoder::begin(void (*output)(const uint8_t *data, uint16_t size))
+        {
+            _output = output;
+            _literalCount = 0;
+            _runCount = 0;
+            _size = 0;
+        }
+
+        void RunLengthEncoder::write(const uint8_t *data, uint16_t size)
+        {
+            for (uint16_t i = 0; i < size; i++)
+                push(data[i]);
+        }
+
+        void RunLengthEncoder::write(uint8_t value, uint16_t size)
+        {
+            for (uint16_t i = 0; i < size; i++)
+                push(value);
+        }
+
+        uint32_t RunLengthEncoder::end()
+        {
+            flushRun();
+            flushLiterals();
+            return _size;
+        }
+
+        void RunLengthEncoder::push(uint8_t value)
+        {
+            if (_runCount > 0 && value == _runValue && _runCount < RUNLENGTH_MAX_RUN)
+            {
+                _runCount++;
+                return;
+            }
+
+            flushRun();
+            _runValue = value;
+            _runCount = 1;
+        }
+
+        void RunLengthEncoder::flushRun()
+        {
+            if (_runCount >= RUNLENGTH_MIN_RUN)
+            {
+                flushLiterals();
+                const uint8_t token[2] = {(uint8_t)(0x80 | (_runCount - RUNLENGTH_MIN_RUN)), _runValue};
+                emit(token, 2);
+            }
+            else
+            {
+                // too short for a run
+                for (uint8_t i = 0; i < _runCount; i++)
+                {
+                    _literals[_literalCount++] = _runValue;
+                    if (_literalCount == RUNLENGTH_MAX_LITERALS)
+                        flushLiterals();
+                }
+            }
+
+            _runCount = 0;
+        }
+
+        void RunLengthEncoder::flushLiterals()
+        {
+            if (_literalCount == 0)
+                return;
+
+            const uint8_t control = _literalCount - 1;
+            emit(&control, 1);
+            emit(_literals, _literalCount);
+            _literalCount = 0;
+        }
+
+        void RunLengthEncoder::emit(const uint8_t *data, uint16_t size)
+        {
+            _size += size;
+            if (_output != nullptr)
+                _output(data, size);
+        }
+
+        int32_t runLengthDecode(const uint8_t *data, uint16_t size, uint8_t *buffer, uint16_t bufferSize)
+        {
+            uint32_t position = 0;
+            uint32_t decoded = 0;
+            while (position < size)
+            {
+                const uint8_t control = data[position++];
+                const bool run = control & 0x80;
+                const uint16_t length = run ? (control & 0x7F) + RUNLENGTH_MIN_RUN : control + 1;
+                const uint16_t encoded = run ? 1 : length;
+
+                if (position + encoded > size)
+                    return -1;
+
+                if (buffer != nullptr)
+                {
+                    if (decoded + length > bufferSize)
+                        return -1;
+
+                    if (run)
+                        memset(buffer + decoded, data[position], length);
+                    else
+                        memcpy(buffer + decoded, data + position, length);
+                }
+
+                position += encoded;
+                decoded += length;
+            }
+
+            return decoded;
+        }
+    } // namespace Flash
+} // namespace OpenKNX
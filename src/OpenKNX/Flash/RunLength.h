@@ -0,0 +1,64 @@
+#pragma once
+#include <Arduino.h>
+
+/*
+ * Run-length encoding (PackBits like) for module data
+ *
+ * > STREAM  := TOKEN*
+ * > TOKEN   := LITERAL | RUN
+ * > LITERAL := CONTROL[1] (0x00..0x7F) ; BYTES[CONTROL + 1]
+ * > RUN     := CONTROL[1] (0x80..0xFF) ; VALUE[1]  ->  VALUE repeated (CONTROL - 0x80 + RUNLENGTH_MIN_RUN) times
+ *
+ * Runs shorter than RUNLENGTH_MIN_RUN are stored as literals, so the worst case
+ * overhead is one byte per RUNLENGTH_MAX_LITERALS bytes.
+ */
+#define RUNLENGTH_MAX_LITERALS 128
+#define RUNLENGTH_MIN_RUN 3
+#define RUNLENGTH_MAX_RUN (0x7F + RUNLENGTH_MIN_RUN)
+
+namespace OpenKNX
+{
+    namespace Flash
+    {
+        /**
+         * Streaming encoder with fixed ram usage (one literal block).
+         * The encoded data is passed to the output function in small pieces.
+         */
+        class RunLengthEncoder
+        {
+          public:
+            /**
+             * @param output receives the encoded data, with nullptr the encoded size is only counted
+             */
+            void begin(void (*output)(const uint8_t *data, uint16_t size));
+            void write(const uint8_t *data, uint16_t size);
+            void write(uint8_t value, uint16_t size);
+
+            /**
+             * Flushes the pending data
+             * @return size of the encoded data (can exceed the input size, so more than 64K for large module data)
+             */
+            uint32_t end();
+
+          private:
+            void (*_output)(const uint8_t *data, uint16_t size) = nullptr;
+            uint8_t _literals[RUNLENGTH_MAX_LITERALS];
+            uint8_t _literalCount = 0;
+            uint8_t _runValue = 0;
+            uint8_t _runCount = 0;
+            uint32_t _size = 0;
+            void push(uint8_t value);
+            void flushRun();
+            void flushLiterals();
+            void emit(const uint8_t *data, uint16_t size);
+        };
+
+        /**
+         * Decodes a run-length encoded stream
+         *
+         * @param buffer receives the decoded data, with nullptr the decoded size is only determined
+         * @return size of the decoded data or -1 if the stream is invalid or does not fit into the buffer
+         */
+        int32_t runLengthDecode(const uint8_t *data, uint16_t size, uint8_t *buffer, uint16_t bufferSize);
+    } // namespace Flash
+} // namespace OpenKNX
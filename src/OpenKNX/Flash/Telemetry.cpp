@@ -0,0 +1,260 @@
+#include "OpenKNX/Flash/Telemetry.h"
+#include "OpenKNX/Facade.h"
+
+#ifdef OPENKNX_FLASH_TELEMETRY
+namespace OpenKNX
+{
+    namespace Flash
+    {
+        const char *Telemetry::logPrefix()
+        {
+            return "Flash<Telemetry>";
+        }
+
+        void Telemetry::init()
+        {
+            initSectors(_sectors[0], openknx.openknxFlash, FLASH_TELEMETRY_KEY_OPENKNX);
+            initSectors(_sectors[1], openknx.knxFlash, FLASH_TELEMETRY_KEY_KNX);
+            load();
+
+            _operatingSince = millis();
+            _persisted = delayTimerInit();
+            _ready = true;
+
+            // early warning
+            for (uint8_t i = 0; i < 2; i++)
+            {
+                uint16_t sector = 0;
+                const uint32_t erases = maxErases(_sectors[i], sector);
+                if (erases > OPENKNX_FLASH_ENDURANCE / 100 * 80)
+                    logErrorP("%s: sector %i is erased %i times (endurance %i)", _sectors[i].driver->logPrefix(), sector, erases, OPENKNX_FLASH_ENDURANCE);
+            }
+        }
+
+        void Telemetry::initSectors(TelemetrySectors &sectors, Driver &driver, uint8_t key)
+        {
+            sectors.driver = &driver;
+            sectors.count = driver.size() / driver.sectorSize();
+            sectors.erases = new uint32_t[sectors.count]();
+            sectors.key = key;
+        }
+
+        void Telemetry::load()
+        {
+            openknx.keyValue.read(FLASH_TELEMETRY_KV_ID, FLASH_TELEMETRY_KEY_SUMMARY, (uint8_t *)&_summary, sizeof(_summary));
+
+            for (uint8_t i = 0; i < 2; i++)
+            {
+                TelemetrySectors &sectors = _sectors[i];
+                for (uint16_t first = 0; first < sectors.count; first += FLASH_TELEMETRY_CHUNK_SECTORS)
+                {
+                    const uint16_t count = MIN(FLASH_TELEMETRY_CHUNK_SECTORS, sectors.count - first);
+                    openknx.keyValue.read(FLASH_TELEMETRY_KV_ID, sectors.key + first / FLASH_TELEMETRY_CHUNK_SECTORS, (uint8_t *)(sectors.erases + first), count * 4);
+                }
+            }
+        }
+
+        void Telemetry::persist(bool force /* = false */)
+        {
+            if (!_ready)
+                return;
+
+            if (!force && !delayCheck(_persisted, OPENKNX_FLASH_TELEMETRY_INTERVAL))
+                return;
+
+            _persisted = delayTimerInit();
+            updateOperatingTime();
+
+            // unchanged values are skipped by the key/value store
+            openknx.keyValue.write(FLASH_TELEMETRY_KV_ID, FLASH_TELEMETRY_KEY_SUMMARY, (uint8_t *)&_summary, sizeof(_summary));
+            for (uint8_t i = 0; i < 2; i++)
+            {
+                TelemetrySectors &sectors = _sectors[i];
+                for (uint16_t first = 0; first < sectors.count; first += FLASH_TELEMETRY_CHUNK_SECTORS)
+                {
+                    const uint16_t count = MIN(FLASH_TELEMETRY_CHUNK_SECTORS, sectors.count - first);
+                    openknx.keyValue.write(FLASH_TELEMETRY_KV_ID, sectors.key + first / FLASH_TELEMETRY_CHUNK_SECTORS, (uint8_t *)(sectors.erases + first), count * 4);
+                }
+            }
+        }
+
+        void Telemetry::updateOperatingTime()
+        {
+            const uint32_t seconds = (millis() - _operatingSince) / 1000;
+            _summary.operatingSeconds += seconds;
+            _operatingSince += seconds * 1000;
+        }
+
+        void Telemetry::recordErase(Driver *driver, uint16_t sector, uint32_t durationMicros)
+        {
+            if (!_ready)
+                return;
+
+            for (uint8_t i = 0; i < 2; i++)
+                if (_sectors[i].driver == driver && sector < _sectors[i].count)
+                    _sectors[i].erases[sector]++;
+
+            count(_summary.eraseHistogram, durationMicros / 1000);
+        }
+
+        void Telemetry::recordSave(uint32_t durationMillis)
+        {
+            _summary.saves++;
+            count(_summary.saveHistogram, durationMillis);
+        }
+
+        void Telemetry::recordSerialize(uint8_t moduleIndex, uint32_t durationMicros)
+        {
+            _serializeLast[moduleIndex] = durationMicros;
+            if (durationMicros > _serializeMax[moduleIndex])
+                _serializeMax[moduleIndex] = durationMicros;
+        }
+
+        uint8_t Telemetry::bucket(uint32_t durationMillis)
+        {
+            uint8_t index = 0;
+            while (index < FLASH_TELEMETRY_BUCKETS - 1 && durationMillis > (1UL << index))
+                index++;
+
+            return index;
+        }
+
+        void Telemetry::count(uint16_t *histogram, uint32_t durationMillis)
+        {
+            // saturated
+            const uint8_t index = bucket(durationMillis);
+            if (histogram[index] < UINT16_MAX)
+                histogram[index]++;
+        }
+
+        uint32_t Telemetry::maxErases(TelemetrySectors &sectors, uint16_t &sector)
+        {
+            uint32_t erases = 0;
+            for (uint16_t i = 0; i < sectors.count; i++)
+            {
+                if (sectors.erases[i] <= erases)
+                    continue;
+
+                erases = sectors.erases[i];
+                sector = i;
+            }
+
+            return erases;
+        }
+
+        void Telemetry::showHistogram(const char *label, uint16_t *histogram)
+        {
+            char line[FLASH_TELEMETRY_BUCKETS * 16] = {};
+            uint16_t length = 0;
+            for (uint8_t i = 0; i < FLASH_TELEMETRY_BUCKETS; i++)
+            {
+                if (i < FLASH_TELEMETRY_BUCKETS - 1)
+                    length += snprintf(line + length, sizeof(line) - length, " <=%lu:%u", 1UL << i, histogram[i]);
+                else
+                    length += snprintf(line + length, sizeof(line) - length, " >%lu:%u", 1UL << (i - 1), histogram[i]);
+            }
+
+            logInfoP("%s (ms):%s", label, line);
+        }
+
+        void Telemetry::showInformations()
+        {
+            if (!_ready)
+                return;
+
+            updateOperatingTime();
+            logInfoP("Operating time %ih, %i saves", _summary.operatingSeconds / 3600, _summary.saves);
+            logIndentUp();
+            showHistogram("Save", _summary.saveHistogram);
+            showHistogram("Erase", _summary.eraseHistogram);
+
+            for (uint8_t i = 0; i < 2; i++)
+            {
+                TelemetrySectors &sectors = _sectors[i];
+                uint32_t total = 0;
+                for (uint16_t j = 0; j < sectors.count; j++)
+                    total += sectors.erases[j];
+
+                uint16_t sector = 0;
+                const uint32_t erases = maxErases(sectors, sector);
+                logInfoP("%s: %i erases in %i sectors, max. %i (sector %i) = %i%% of endurance", sectors.driver->logPrefix(), total, sectors.count, erases, sector, erases * 100 / OPENKNX_FLASH_ENDURANCE);
+
+                // same rate as up to now
+                if (erases > 0 && erases < OPENKNX_FLASH_ENDURANCE)
+                {
+                    logIndentUp();
+                    logInfoP("Estimated lifetime: %i days", (uint32_t)((uint64_t)(OPENKNX_FLASH_ENDURANCE - erases) * _summary.operatingSeconds / erases / 86400));
+                    logIndentDown();
+                }
+            }
+
+            for (uint8_t i = 0; i < openknx.modules.count; i++)
+            {
+                if (_serializeMax[i] == 0)
+                    continue;
+
+                logInfoP("Save module %s: last %ius, max. %ius", openknx.modules.list[i]->name().c_str(), _serializeLast[i], _serializeMax[i]);
+            }
+            logIndentDown();
+        }
+
+        static void appendValue(uint8_t *data, uint8_t &length, uint32_t value, uint8_t size)
+        {
+            for (uint8_t i = size; i > 0; i--)
+                data[length++] = (value >> ((i - 1) * 8)) & 0xFF;
+        }
+
+        bool Telemetry::processFunctionProperty(uint8_t length, uint8_t *data, uint8_t *resultData, uint8_t &resultLength)
+        {
+            if (length < 1)
+                return false;
+
+            const uint8_t request = data[0];
+            resultLength = 0;
+            resultData[resultLength++] = 0;
+
+            if (!_ready)
+            {
+                resultData[0] = 1;
+                return true;
+            }
+
+            switch (request)
+            {
+                case 0:
+                    updateOperatingTime();
+                    appendValue(resultData, resultLength, _summary.operatingSeconds, 4);
+                    appendValue(resultData, resultLength, _summary.saves, 4);
+                    for (uint8_t i = 0; i < 2; i++)
+                    {
+                        uint16_t sector = 0;
+                        appendValue(resultData, resultLength, maxErases(_sectors[i], sector), 4);
+                        appendValue(resultData, resultLength, sector, 2);
+                        appendValue(resultData, resultLength, _sectors[i].count, 2);
+                    }
+                    return true;
+
+                case 1:
+                case 2:
+                    for (uint8_t i = 0; i < FLASH_TELEMETRY_BUCKETS; i++)
+                        appendValue(resultData, resultLength, (request == 1 ? _summary.saveHistogram : _summary.eraseHistogram)[i], 2);
+                    return true;
+            }
+
+            // erase counters of 8 sectors
+            TelemetrySectors &sectors = _sectors[request >= FLASH_TELEMETRY_KEY_KNX ? 1 : 0];
+            const uint16_t first = (request - sectors.key) * 8;
+            if (request < FLASH_TELEMETRY_KEY_OPENKNX || request >= FLASH_TELEMETRY_KEY_KNX + 0x30 || first >= sectors.count)
+            {
+                resultData[0] = 1;
+                return true;
+            }
+
+            for (uint16_t i = first; i < first + 8 && i < sectors.count; i++)
+                appendValue(resultData, resultLength, sectors.erases[i], 4);
+
+            return true;
+        }
+    } // namespace Flash
+} // namespace OpenKNX
+#endif
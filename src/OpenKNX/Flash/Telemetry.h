@@ -0,0 +1,97 @@
+#pragma once
+#include "OpenKNX/Flash/Driver.h"
+#include "OpenKNX/defines.h"
+
+#ifdef OPENKNX_FLASH_TELEMETRY
+    #if OPENKNX_FLASH_KV_SIZE == 0
+        #error "OPENKNX_FLASH_TELEMETRY needs the key/value store (OPENKNX_FLASH_KV_SIZE)"
+    #endif
+#endif
+
+/*
+ * Flash wear and save latency telemetry
+ *
+ * Erase counters per sector (knx and openknx flash) and histograms of save and erase durations
+ * are kept in the key/value store (module id FLASH_TELEMETRY_KV_ID), so they survive reboots.
+ * Serialize times of the modules are only kept in ram.
+ *
+ * Keys:
+ * > 0               := OPERATING_SECONDS[4] ; SAVES[4] ; SAVE_HISTOGRAM[2 * N] ; ERASE_HISTOGRAM[2 * N]
+ * > 0x10 + chunk    := ERASES[4] * FLASH_TELEMETRY_CHUNK_SECTORS (openknx flash)
+ * > 0x40 + chunk    := ERASES[4] * FLASH_TELEMETRY_CHUNK_SECTORS (knx flash)
+ *
+ * Histogram bucket i counts durations up to 2^i ms, the last bucket all longer durations.
+ */
+#define FLASH_TELEMETRY_KV_ID 0
+#define FLASH_TELEMETRY_KEY_SUMMARY 0
+#define FLASH_TELEMETRY_KEY_OPENKNX 0x10
+#define FLASH_TELEMETRY_KEY_KNX 0x40
+#define FLASH_TELEMETRY_CHUNK_SECTORS 16
+#define FLASH_TELEMETRY_BUCKETS 12
+
+namespace OpenKNX
+{
+    namespace Flash
+    {
+        struct TelemetrySummary
+        {
+            uint32_t operatingSeconds = 0;
+            uint32_t saves = 0;
+            uint16_t saveHistogram[FLASH_TELEMETRY_BUCKETS] = {};
+            uint16_t eraseHistogram[FLASH_TELEMETRY_BUCKETS] = {};
+        };
+
+        /**
+         * Erase counters of all sectors of a flash driver
+         */
+        struct TelemetrySectors
+        {
+            Driver *driver = nullptr;
+            uint32_t *erases = nullptr;
+            uint16_t count = 0;
+            uint8_t key = 0;
+        };
+
+        class Telemetry
+        {
+          public:
+            void init();
+
+            /**
+             * Persists the data if OPENKNX_FLASH_TELEMETRY_INTERVAL is elapsed (or always with force)
+             */
+            void persist(bool force = false);
+
+            void recordErase(Driver *driver, uint16_t sector, uint32_t durationMicros);
+            void recordSave(uint32_t durationMillis);
+            void recordSerialize(uint8_t moduleIndex, uint32_t durationMicros);
+
+            void showInformations();
+
+            /**
+             * Function property for telemetry (OPENKNX_FLASH_TELEMETRY_PROPERTY_OBJECT/_ID)
+             * data[0]: 0 = summary, 1 = save histogram, 2 = erase histogram,
+             *          0x10 + n = erase counters of openknx flash from sector 8 * n, 0x40 + n = same for knx flash
+             * All values are big-endian.
+             */
+            bool processFunctionProperty(uint8_t length, uint8_t *data, uint8_t *resultData, uint8_t &resultLength);
+
+          private:
+            bool _ready = false;
+            TelemetrySummary _summary;
+            TelemetrySectors _sectors[2];
+            uint32_t _serializeLast[OPENKNX_MAX_MODULES] = {};
+            uint32_t _serializeMax[OPENKNX_MAX_MODULES] = {};
+            uint32_t _operatingSince = 0;
+            uint32_t _persisted = 0;
+            void initSectors(TelemetrySectors &sectors, Driver &driver, uint8_t key);
+            void load();
+            void updateOperatingTime();
+            uint32_t maxErases(TelemetrySectors &sectors, uint16_t &sector);
+            uint8_t bucket(uint32_t durationMillis);
+            void count(uint16_t *histogram, uint32_t durationMillis);
+            void showHistogram(const char *label, uint16_t *histogram);
+            const char *logPrefix();
+        };
+    } // namespace Flash
+} // namespace OpenKNX
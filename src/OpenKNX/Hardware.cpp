@@ -46,6 +46,8 @@ namespace OpenKNX
         openknx.openknxFlash.init("openknx", OPENKNX_FLASH_OFFSET, OPENKNX_FLASH_SIZE);
         openknx.knxFlash.init("knx", KNX_FLASH_OFFSET, KNX_FLASH_SIZE);
 #endif
+        // combine writes of the knx stack into alternating tables
+        openknx.knxFlash.cacheSectors(OPENKNX_FLASH_CACHE_SECTORS);
 
 #ifdef KNX_FLASH_CALLBACK
         // register callbacks
@@ -90,7 +92,7 @@ namespace OpenKNX
 
     void Hardware::requestBcuSystemState()
     {
-        logDebug(openknx.logger.buildPrefix("Hardware", "BCU"), "Request system state");
+        logDebug("Hardware<BCU>", "Request system state");
         logIndentUp();
         uint8_t command[] = {U_SYSTEM_STATE, U_SYSTEM_STAT_IND};
         sendCommandToBcu(command, 2, "SYSTEM_STATE");
@@ -102,7 +104,7 @@ namespace OpenKNX
         if ((response[1] & 3) == 3) // second byte
             features |= BOARD_HW_NCN5130;
 
-        logHexTrace(openknx.logger.buildPrefix("Hardware", "BCU"), response, 2);
+        logHexTrace("Hardware<BCU>", response, 2);
         logIndentDown();
     }
 
@@ -112,7 +114,7 @@ namespace OpenKNX
             return;
 
         if (debug != nullptr)
-            logTrace(openknx.logger.buildPrefix("Hardware", "BCU"), "Send command %s to BCU", debug);
+            logTrace("Hardware<BCU>", "Send command %s to BCU", debug);
 
         // send system state command and interpret answer
         knx.platform().knxUart()->flush();
@@ -139,8 +141,8 @@ namespace OpenKNX
         {
             if (expected[i] != response[i])
             {
-                logError(openknx.logger.buildPrefix("Hardware", "BCU"), "FAILED - received unexpected response:");
-                logHexError(openknx.logger.buildPrefix("Hardware", "BCU"), response, length);
+                logError("Hardware<BCU>", "FAILED - received unexpected response:");
+                logHexError("Hardware<BCU>", response, length);
                 return false;
             }
         }
@@ -150,7 +152,7 @@ namespace OpenKNX
 
     void Hardware::deactivatePowerRail()
     {
-        logDebug(openknx.logger.buildPrefix("Hardware", "BCU"), "Switching off 5V / 20V rail of BCU");
+        logDebug("Hardware<BCU>", "Switching off 5V / 20V rail of BCU");
         logIndentUp();
         uint8_t command[] = {U_INT_REG_WR_REQ_ACR0, ACR0_FLAG_XCLKEN | ACR0_FLAG_V20VCLIMIT};
         sendCommandToBcu(command, 2, "U_INT_REG_WR_REQ_ACR0");
@@ -160,7 +162,7 @@ namespace OpenKNX
 
     void Hardware::activatePowerRail()
     {
-        logDebug(openknx.logger.buildPrefix("Hardware", "BCU"), "Switching on 5V rail of BCU");
+        logDebug("Hardware<BCU>", "Switching on 5V rail of BCU");
         logIndentUp();
         uint8_t command[] = {U_INT_REG_WR_REQ_ACR0, ACR0_FLAG_DC2EN | ACR0_FLAG_V20VEN | ACR0_FLAG_XCLKEN | ACR0_FLAG_V20VCLIMIT};
         sendCommandToBcu(command, 2, "U_INT_REG_WR_REQ_ACR0");
@@ -169,7 +171,7 @@ namespace OpenKNX
 
     void Hardware::stopKnxMode(bool waiting /* = true */)
     {
-        logDebug(openknx.logger.buildPrefix("Hardware", "BCU"), "Stop KNX Mode");
+        logDebug("Hardware<BCU>", "Stop KNX Mode");
         logIndentUp();
         uint8_t command[] = {U_STOP_MODE_REQ};
         sendCommandToBcu(command, 1, "STOP_MODE");
@@ -187,7 +189,7 @@ namespace OpenKNX
 
     void Hardware::startKnxMode(bool waiting /* = true */)
     {
-        logDebug(openknx.logger.buildPrefix("Hardware", "BCU"), "Start KNX Mode");
+        logDebug("Hardware<BCU>", "Start KNX Mode");
         logIndentUp();
         uint8_t command[] = {U_EXIT_STOP_MODE_REQ};
         sendCommandToBcu(command, 1, "EXIT_STOP_MODE"); // U_RESET_IND
@@ -223,6 +225,7 @@ namespace OpenKNX
 #ifdef WATCHDOG
             Watchdog.reset();
 #endif
+            openknx.logger.flush();
             delay(2000);
             // Repeat error message
             logError("FatalError", "Code: %d (%s)", code, message);
@@ -11,6 +11,7 @@ namespace OpenKNX
 
         _pin = pin;
         _activeOn = activeOn;
+        _logPrefix.set("LED", _pin);
 
         pinMode(_pin, OUTPUT);
         digitalWrite(_pin, LOW);
@@ -264,9 +265,12 @@ namespace OpenKNX
         _effectMode = true;
     }
 
-    std::string Led::logPrefix()
+    const char* Led::logPrefix()
     {
-        return openknx.logger.buildPrefix("LED", _pin);
+        if (_logPrefix.empty())
+            _logPrefix.set("LED", _pin);
+
+        return _logPrefix;
     }
 
 } // namespace OpenKNX
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "OpenKNX/LedEffects/Error.h"
 #include "OpenKNX/LedEffects/Flash.h"
 #include "OpenKNX/LedEffects/Pulse.h"
+#include "OpenKNX/Log/Logger.h"
 #include "OpenKNX/defines.h"
 #include <Arduino.h>
 #include <string>
@@ -14,6 +15,7 @@ namespace OpenKNX
     {
       private:
         volatile long _pin = -1;
+        Log::Prefix _logPrefix;
         volatile long _activeOn = HIGH;
         volatile uint32_t _lastMillis = 0;
         volatile uint8_t _brightness = 255;
@@ -134,8 +136,8 @@ namespace OpenKNX
         void loadEffect(LedEffects::Base *effect);
 
         /*
-         * Get a logPrefix as string
+         * Get the prefix for log (no allocation)
          */
-        std::string logPrefix();
+        const char* logPrefix();
     };
 } // namespace OpenKNX
\ No newline at end of file
@@ -0,0 +1,323 @@
+#include "OpenKNX/Log/BinaryLog.h"
+#include <stddef.h>
+
+namespace OpenKNX
+{
+    namespace Log
+    {
+        struct FormatSpec
+        {
+            const char* start;
+            uint8_t length;
+            uint8_t stars;    // width and/or precision given as argument
+            char size;        // 0 = int, 'H' = hh, 'h', 'l', 'L' = ll, 'z', 'j', 't', 'D' = long double
+            char conversion;
+        };
+
+        /*
+         * Find the next conversion specification (%% included) in format.
+         * Returns the position behind it or nullptr at the end of format.
+         */
+        static const char* nextSpec(const char* format, FormatSpec& spec)
+        {
+            while (*format != '%')
+            {
+                if (*format == 0)
+                    return nullptr;
+
+                format++;
+            }
+
+            spec.start = format++;
+            spec.stars = 0;
+            spec.size = 0;
+
+            while (*format && strchr("-+ #0", *format))
+                format++;
+
+            if (*format == '*')
+            {
+                spec.stars++;
+                format++;
+            }
+            while (*format >= '0' && *format <= '9')
+                format++;
+
+            if (*format == '.')
+            {
+                format++;
+                if (*format == '*')
+                {
+                    spec.stars++;
+                    format++;
+                }
+                while (*format >= '0' && *format <= '9')
+                    format++;
+            }
+
+            switch (*format)
+            {
+                case 'h':
+                case 'l':
+                    spec.size = *format++;
+                    if (*format == spec.size)
+                    {
+                        spec.size = spec.size == 'h' ? 'H' : 'L';
+                        format++;
+                    }
+                    break;
+                case 'z':
+                case 'j':
+                case 't':
+                    spec.size = *format++;
+                    break;
+                case 'L':
+                    spec.size = 'D';
+                    format++;
+                    break;
+            }
+
+            spec.conversion = *format;
+            if (*format)
+                format++;
+
+            spec.length = format - spec.start;
+            return format;
+        }
+
+        template <typename T>
+        static bool appendValue(uint8_t* buffer, uint16_t bufferSize, uint16_t& length, T value)
+        {
+            if (length + sizeof(T) > bufferSize)
+                return false;
+
+            memcpy(buffer + length, &value, sizeof(T));
+            length += sizeof(T);
+            return true;
+        }
+
+        template <typename T>
+        static bool readValue(const uint8_t* data, uint16_t size, uint16_t& position, T& value)
+        {
+            if (position + sizeof(T) > size)
+                return false;
+
+            memcpy(&value, data + position, sizeof(T));
+            position += sizeof(T);
+            return true;
+        }
+
+        template <typename T>
+        static void printValue(Print& out, const char* spec, const int* stars, uint8_t starCount, T value)
+        {
+            char buffer[BINARY_LOG_MAX_STRING + 32];
+            if (starCount == 0)
+                snprintf(buffer, sizeof(buffer), spec, value);
+            else if (starCount == 1)
+                snprintf(buffer, sizeof(buffer), spec, stars[0], value);
+            else
+                snprintf(buffer, sizeof(buffer), spec, stars[0], stars[1], value);
+
+            out.print(buffer);
+        }
+
+        static bool isInteger(char conversion)
+        {
+            return strchr("diuxXoc", conversion) != nullptr;
+        }
+
+        static bool isFloat(char conversion)
+        {
+            return strchr("fFeEgGaA", conversion) != nullptr;
+        }
+
+        int32_t binaryEncodeArguments(uint8_t* buffer, uint16_t bufferSize, const char* format, va_list& values)
+        {
+            FormatSpec spec;
+            uint16_t length = 0;
+            bool success = true;
+
+            while (success && (format = nextSpec(format, spec)) != nullptr)
+            {
+                for (uint8_t i = 0; i < spec.stars; i++)
+                    success &= appendValue(buffer, bufferSize, length, va_arg(values, int));
+
+                if (spec.conversion == '%')
+                    continue;
+
+                if (isInteger(spec.conversion))
+                {
+                    switch (spec.size)
+                    {
+                        case 'l':
+                            success &= appendValue(buffer, bufferSize, length, va_arg(values, long));
+                            break;
+                        case 'L':
+                            success &= appendValue(buffer, bufferSize, length, va_arg(values, long long));
+                            break;
+                        case 'z':
+                            success &= appendValue(buffer, bufferSize, length, va_arg(values, size_t));
+                            break;
+                        case 'j':
+                            success &= appendValue(buffer, bufferSize, length, va_arg(values, intmax_t));
+                            break;
+                        case 't':
+                            success &= appendValue(buffer, bufferSize, length, va_arg(values, ptrdiff_t));
+                            break;
+                        default:
+                            success &= appendValue(buffer, bufferSize, length, va_arg(values, int));
+                    }
+                }
+                else if (isFloat(spec.conversion))
+                {
+                    if (spec.size == 'D')
+                        success &= appendValue(buffer, bufferSize, length, (double)va_arg(values, long double));
+                    else
+                        success &= appendValue(buffer, bufferSize, length, va_arg(values, double));
+                }
+                else if (spec.conversion == 's')
+                {
+                    const char* string = va_arg(values, const char*);
+                    if (string == nullptr)
+                        string = "(null)";
+
+                    const uint8_t stringLength = strnlen(string, BINARY_LOG_MAX_STRING);
+                    success &= appendValue(buffer, bufferSize, length, stringLength);
+                    success &= length + stringLength <= bufferSize;
+                    if (success)
+                    {
+                        memcpy(buffer + length, string, stringLength);
+                        length += stringLength;
+                    }
+                }
+                else if (spec.conversion == 'p')
+                {
+                    success &= appendValue(buffer, bufferSize, length, va_arg(values, void*));
+                }
+                else
+                {
+                    // %n or invalid
+                    return -1;
+                }
+            }
+
+            return success ? length : -1;
+        }
+
+        void binaryFormatArguments(Print& out, const char* format, const uint8_t* data, uint16_t size)
+        {
+            FormatSpec spec;
+            uint16_t position = 0;
+            const char* next = nullptr;
+
+            while ((next = nextSpec(format, spec)) != nullptr)
+            {
+                // text in front of the specification
+                out.write((const uint8_t*)format, spec.start - format);
+                format = next;
+
+                if (spec.conversion == '%')
+                {
+                    out.print("%");
+                    continue;
+                }
+
+                char specString[16] = {};
+                memcpy(specString, spec.start, MIN(spec.length, sizeof(specString) - 1));
+
+                int stars[2] = {};
+                bool success = true;
+                for (uint8_t i = 0; i < spec.stars; i++)
+                    success &= readValue(data, size, position, stars[i]);
+
+                if (isInteger(spec.conversion))
+                {
+                    switch (spec.size)
+                    {
+                        case 'l':
+                        {
+                            long value = 0;
+                            if ((success &= readValue(data, size, position, value)))
+                                printValue(out, specString, stars, spec.stars, value);
+                            break;
+                        }
+                        case 'L':
+                        {
+                            long long value = 0;
+                            if ((success &= readValue(data, size, position, value)))
+                                printValue(out, specString, stars, spec.stars, value);
+                            break;
+                        }
+                        case 'z':
+                        {
+                            size_t value = 0;
+                            if ((success &= readValue(data, size, position, value)))
+                                printValue(out, specString, stars, spec.stars, value);
+                            break;
+                        }
+                        case 'j':
+                        {
+                            intmax_t value = 0;
+                            if ((success &= readValue(data, size, position, value)))
+                                printValue(out, specString, stars, spec.stars, value);
+                            break;
+                        }
+                        case 't':
+                        {
+                            ptrdiff_t value = 0;
+                            if ((success &= readValue(data, size, position, value)))
+                                printValue(out, specString, stars, spec.stars, value);
+                            break;
+                        }
+                        default:
+                        {
+                            int value = 0;
+                            if ((success &= readValue(data, size, position, value)))
+                                printValue(out, specString, stars, spec.stars, value);
+                        }
+                    }
+                }
+                else if (isFloat(spec.conversion))
+                {
+                    double value = 0;
+                    // stored as double
+                    if (spec.size == 'D')
+                        memmove(specString + spec.length - 2, specString + spec.length - 1, 2);
+
+                    if ((success &= readValue(data, size, position, value)))
+                        printValue(out, specString, stars, spec.stars, value);
+                }
+                else if (spec.conversion == 's')
+                {
+                    uint8_t stringLength = 0;
+                    char string[BINARY_LOG_MAX_STRING + 1] = {};
+                    success &= readValue(data, size, position, stringLength) && position + stringLength <= size;
+                    if (success)
+                    {
+                        memcpy(string, data + position, stringLength);
+                        position += stringLength;
+                        printValue(out, specString, stars, spec.stars, (const char*)string);
+                    }
+                }
+                else if (spec.conversion == 'p')
+                {
+                    void* value = nullptr;
+                    if ((success &= readValue(data, size, position, value)))
+                        printValue(out, specString, stars, spec.stars, value);
+                }
+                else
+                {
+                    success = false;
+                }
+
+                if (!success)
+                {
+                    out.print("<?>");
+                    return;
+                }
+            }
+
+            out.print(format);
+        }
+    } // namespace Log
+} // namespace OpenKNX
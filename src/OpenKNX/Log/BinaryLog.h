@@ -0,0 +1,34 @@
+#pragma once
+#include "Arduino.h"
+
+/*
+ * Deferred formatting of log messages
+ *
+ * Instead of formatting at the call site, the arguments of a printf format string are stored raw
+ * and formatted later (on drain of the logger or on the host with decode_binary_log.py).
+ *
+ * > ARGS := ARG*
+ * > ARG  := INTEGER[sizeof(type)] | DOUBLE[8] | STRING_LEN[1] ; STRING[STRING_LEN]
+ *
+ * Values are stored in native byte order with the size of the C type after default promotions
+ * (%hhd and %hd as int, %ld as long, %lld as long long, %f as double).
+ * Strings are copied and truncated at BINARY_LOG_MAX_STRING. %n is not supported.
+ */
+#define BINARY_LOG_MAX_STRING 64
+
+namespace OpenKNX
+{
+    namespace Log
+    {
+        /*
+         * Stores the arguments for format into buffer.
+         * Returns the size of the arguments or -1 if the buffer is too small.
+         */
+        int32_t binaryEncodeArguments(uint8_t* buffer, uint16_t bufferSize, const char* format, va_list& values);
+
+        /*
+         * Prints format with arguments stored by binaryEncodeArguments.
+         */
+        void binaryFormatArguments(Print& out, const char* format, const uint8_t* data, uint16_t size);
+    } // namespace Log
+} // namespace OpenKNX
@@ -0,0 +1,134 @@
+#include "OpenKNX/Log/CrashSink.h"
+#if defined(ARDUINO_ARCH_RP2040) && defined(OPENKNX_LOGGER_SINK_CRASH)
+    #include "OpenKNX/Facade.h"
+    #include "OpenKNX/Flash/Crc32.h"
+    #include "hardware/watchdog.h"
+    #include <stddef.h>
+
+    #define LOGGER_CRASH_MAGIC 0x4B4C4F47
+
+namespace OpenKNX
+{
+    namespace Log
+    {
+        // not cleared on startup (also not zeroed on power on, so magic and CRC decide)
+        static CrashSink::Buffer crashBuffers[2] __attribute__((section(".uninitialized_data.openknx_crash_log")));
+
+        CrashSink::CrashSink(uint8_t level)
+            : Sink(level, false)
+        {
+            // the newest valid buffer contains the previous run
+            for (Buffer& buffer : crashBuffers)
+                if (valid(buffer) && (_previous == nullptr || (int32_t)(buffer.sequence - _previous->sequence) > 0))
+                    _previous = &buffer;
+
+            _current = (_previous == &crashBuffers[0]) ? &crashBuffers[1] : &crashBuffers[0];
+            _current->magic = LOGGER_CRASH_MAGIC;
+            _current->sequence = _previous ? _previous->sequence + 1 : 1;
+            _current->size = OPENKNX_LOGGER_SINK_CRASH;
+            _current->position = 0;
+            _current->wrapped = 0;
+            seal(*_current);
+
+            _watchdog = watchdog_caused_reboot();
+        }
+
+        const char* CrashSink::name()
+        {
+            return "crash";
+        }
+
+        bool CrashSink::immediate()
+        {
+            return true;
+        }
+
+        bool CrashSink::valid(Buffer& buffer)
+        {
+            return buffer.magic == LOGGER_CRASH_MAGIC &&
+                   buffer.size == OPENKNX_LOGGER_SINK_CRASH &&
+                   buffer.position < OPENKNX_LOGGER_SINK_CRASH &&
+                   buffer.check == Flash::crc32(0, (const uint8_t*)&buffer, offsetof(Buffer, check));
+        }
+
+        void CrashSink::seal(Buffer& buffer)
+        {
+            buffer.check = Flash::crc32(0, (const uint8_t*)&buffer, offsetof(Buffer, check));
+        }
+
+        void CrashSink::writeOutput(const uint8_t* data, size_t size)
+        {
+            // data first, so a reset during the write leaves a valid header
+            while (size > 0)
+            {
+                const uint32_t part = MIN(size, OPENKNX_LOGGER_SINK_CRASH - _current->position);
+                memcpy(_current->data + _current->position, data, part);
+                _current->position += part;
+                data += part;
+                size -= part;
+                if (_current->position == OPENKNX_LOGGER_SINK_CRASH)
+                {
+                    _current->position = 0;
+                    _current->wrapped = 1;
+                }
+            }
+
+            seal(*_current);
+        }
+
+        bool CrashSink::available()
+        {
+            return _previous != nullptr && (_previous->position > 0 || _previous->wrapped);
+        }
+
+        void CrashSink::loop()
+        {
+            // report once after setup (the console is ready)
+            if (_reported)
+                return;
+
+            _reported = true;
+            if (!available())
+                return;
+
+    #ifdef OPENKNX_LOGGER_SINK_CRASH_PRINT
+            show();
+    #else
+            logInfo("Logger", "Log of the previous run available%s, show with \"log sink crash\"", _watchdog ? " (watchdog reset)" : "");
+    #endif
+        }
+
+        void CrashSink::print(Print& out, Buffer& buffer)
+        {
+            if (buffer.wrapped)
+                out.write(buffer.data + buffer.position, OPENKNX_LOGGER_SINK_CRASH - buffer.position);
+
+            out.write(buffer.data, buffer.position);
+        }
+
+        void CrashSink::print(Print& out)
+        {
+            if (available())
+                print(out, *_previous);
+        }
+
+        void CrashSink::show()
+        {
+            if (!available())
+            {
+                openknx.logger.logWithPrefix("Logger", "No log of the previous run");
+                return;
+            }
+
+            openknx.logger.logWithPrefixAndValues("Logger", "Log of the previous run%s:", _watchdog ? " (watchdog reset)" : "");
+            // directly to the device, otherwise the output would be appended while printing
+            openknx.logger.flush();
+            openknx.logger.begin();
+            openknx.logger.clearPreviouseLine();
+            print(OPENKNX_LOGGER_DEVICE);
+            openknx.logger.printPrompt();
+            openknx.logger.end();
+        }
+    } // namespace Log
+} // namespace OpenKNX
+#endif
@@ -0,0 +1,63 @@
+#pragma once
+#if defined(ARDUINO_ARCH_RP2040) && defined(OPENKNX_LOGGER_SINK_CRASH)
+    #include "OpenKNX/Log/Sink.h"
+
+namespace OpenKNX
+{
+    namespace Log
+    {
+        /*
+         * Keeps the last OPENKNX_LOGGER_SINK_CRASH bytes of log output in RAM which is not initialized on startup,
+         * so it survives a warm reset (watchdog, fatal error, restart). The buffers are guarded by magic and CRC.
+         * Two buffers are used alternately: the log of the previous run stays readable with "log sink crash"
+         * while the current run is recorded.
+         */
+        class CrashSink : public Sink
+        {
+          public:
+            struct Buffer
+            {
+                uint32_t magic;
+                // incremented on each start
+                uint32_t sequence;
+                uint32_t size;
+                uint32_t position;
+                uint32_t wrapped;
+                // CRC-32 of the fields above
+                uint32_t check;
+                uint8_t data[OPENKNX_LOGGER_SINK_CRASH];
+            };
+
+          private:
+            Buffer* _current = nullptr;
+            Buffer* _previous = nullptr;
+            bool _reported = false;
+            bool _watchdog = false;
+
+            static bool valid(Buffer& buffer);
+            static void seal(Buffer& buffer);
+            void print(Print& out, Buffer& buffer);
+
+          protected:
+            void writeOutput(const uint8_t* data, size_t size) override;
+
+          public:
+            CrashSink(uint8_t level);
+            const char* name() override;
+            bool immediate() override;
+            void loop() override;
+            void show() override;
+
+            /*
+             * Log of the previous run is available (after a warm reset)
+             */
+            bool available();
+
+            /*
+             * Write the log of the previous run (oldest first)
+             */
+            void print(Print& out);
+        };
+    } // namespace Log
+} // namespace OpenKNX
+#endif
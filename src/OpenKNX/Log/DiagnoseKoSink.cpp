@@ -0,0 +1,79 @@
+#include "OpenKNX/Log/DiagnoseKoSink.h"
+#ifdef LOG_KoDiagnose
+    #include "OpenKNX/Facade.h"
+
+namespace OpenKNX
+{
+    namespace Log
+    {
+        DiagnoseKoSink::DiagnoseKoSink(uint8_t level)
+            : Sink(level, false)
+        {
+        }
+
+        const char* DiagnoseKoSink::name()
+        {
+            return "diagnose";
+        }
+
+        void DiagnoseKoSink::writeOutput(const uint8_t* data, size_t size)
+        {
+            for (size_t i = 0; i < size; i++)
+            {
+                const char c = data[i];
+                if (_pending)
+                {
+                    // the line ends, the next one is lost
+                    if (c == '\n')
+                        _dropped++;
+
+                    continue;
+                }
+
+                if (c == '\n')
+                {
+                    _pending = _length > 0;
+                    _space = false;
+                    continue;
+                }
+
+                // collapse padding of prefix and indent
+                if (c == ' ' || c == '\r')
+                {
+                    _space = _length > 0;
+                    continue;
+                }
+
+                if (_space && _length < OPENKNX_LOGGER_SINK_DIAGNOSE_LENGTH)
+                    _line[_length++] = ' ';
+                _space = false;
+
+                if (_length < OPENKNX_LOGGER_SINK_DIAGNOSE_LENGTH)
+                    _line[_length++] = c;
+            }
+        }
+
+        void DiagnoseKoSink::loop()
+        {
+            if (!_pending)
+                return;
+
+            char part[15] = {};
+            for (uint8_t position = 0; position < _length; position += 14)
+            {
+                memcpy(part, _line + position, MIN(14, _length - position));
+                part[MIN(14, _length - position)] = 0;
+                openknx.console.writeDiagenoseKo("%s", part);
+            }
+
+            _length = 0;
+            _pending = false;
+        }
+
+        void DiagnoseKoSink::show()
+        {
+            openknx.logger.logWithPrefixAndValues("Logger", "diagnose: %i lines dropped", _dropped);
+        }
+    } // namespace Log
+} // namespace OpenKNX
+#endif
@@ -0,0 +1,37 @@
+#pragma once
+#ifdef LOG_KoDiagnose
+    #include "OpenKNX/Log/Sink.h"
+
+    #ifndef OPENKNX_LOGGER_SINK_DIAGNOSE_LENGTH
+        #define OPENKNX_LOGGER_SINK_DIAGNOSE_LENGTH 56
+    #endif
+
+namespace OpenKNX
+{
+    namespace Log
+    {
+        /*
+         * Sends log lines on the diagnose KO (in parts of 14 chars, padding removed).
+         * Only one line is pending, lines are dropped until it is sent in loop.
+         */
+        class DiagnoseKoSink : public Sink
+        {
+          private:
+            char _line[OPENKNX_LOGGER_SINK_DIAGNOSE_LENGTH + 1] = {};
+            volatile uint8_t _length = 0;
+            volatile bool _pending = false;
+            bool _space = false;
+            uint32_t _dropped = 0;
+
+          protected:
+            void writeOutput(const uint8_t* data, size_t size) override;
+
+          public:
+            DiagnoseKoSink(uint8_t level);
+            const char* name() override;
+            void loop() override;
+            void show() override;
+        };
+    } // namespace Log
+} // namespace OpenKNX
+#endif
@@ -0,0 +1,88 @@
+#include "OpenKNX/Log/FileSink.h"
+#ifdef ARDUINO_ARCH_RP2040
+    #include "LittleFS.h"
+    #include "OpenKNX/Facade.h"
+
+namespace OpenKNX
+{
+    namespace Log
+    {
+        FileSink::FileSink(const char* path, uint32_t maxSize, uint8_t level)
+            : Sink(level, false)
+        {
+            _path = path;
+            _maxSize = maxSize;
+            _buffer = new uint8_t[OPENKNX_LOGGER_SINK_FILE_BUFFER];
+            _writeBuffer = new uint8_t[OPENKNX_LOGGER_SINK_FILE_BUFFER];
+        }
+
+        const char* FileSink::name()
+        {
+            return "file";
+        }
+
+        void FileSink::writeOutput(const uint8_t* data, size_t size)
+        {
+            if (_length + size > OPENKNX_LOGGER_SINK_FILE_BUFFER)
+            {
+                _dropped++;
+                return;
+            }
+
+            memcpy(_buffer + _length, data, size);
+            _length += size;
+        }
+
+        void FileSink::loop()
+        {
+            if (_length == 0)
+                return;
+
+            if (_length < OPENKNX_LOGGER_SINK_FILE_BUFFER / 2 && !delayCheckMillis(_lastWrite, OPENKNX_LOGGER_SINK_FILE_INTERVAL))
+                return;
+
+            flush();
+        }
+
+        void FileSink::flush()
+        {
+            // take the collected lines in the lock, but write the file outside
+            openknx.logger.begin();
+            const uint16_t length = _length;
+            memcpy(_writeBuffer, _buffer, length);
+            _length = 0;
+            openknx.logger.end();
+
+            _lastWrite = millis();
+            if (length > 0)
+                writeFile(_writeBuffer, length);
+        }
+
+        void FileSink::writeFile(const uint8_t* data, uint16_t size)
+        {
+            File file = LittleFS.open(_path.c_str(), "a");
+            if (!file)
+                return;
+
+            if (file.size() + size > _maxSize)
+            {
+                file.close();
+                const std::string old = _path + ".old";
+                LittleFS.remove(old.c_str());
+                LittleFS.rename(_path.c_str(), old.c_str());
+                file = LittleFS.open(_path.c_str(), "a");
+                if (!file)
+                    return;
+            }
+
+            file.write(data, size);
+            file.close();
+        }
+
+        void FileSink::show()
+        {
+            openknx.logger.logWithPrefixAndValues("Logger", "file: %s (max. %i bytes), %i lines dropped", _path.c_str(), _maxSize, _dropped);
+        }
+    } // namespace Log
+} // namespace OpenKNX
+#endif
@@ -0,0 +1,47 @@
+#pragma once
+#ifdef ARDUINO_ARCH_RP2040
+    #include "OpenKNX/Log/Sink.h"
+    #include <string>
+
+    #ifndef OPENKNX_LOGGER_SINK_FILE_BUFFER
+        #define OPENKNX_LOGGER_SINK_FILE_BUFFER 1024
+    #endif
+
+    #ifndef OPENKNX_LOGGER_SINK_FILE_INTERVAL
+        #define OPENKNX_LOGGER_SINK_FILE_INTERVAL 10000
+    #endif
+
+namespace OpenKNX
+{
+    namespace Log
+    {
+        /*
+         * Appends log lines to a file on LittleFS. Lines are collected in RAM and written in loop
+         * (every OPENKNX_LOGGER_SINK_FILE_INTERVAL ms or if the buffer is half full) to save flash writes.
+         * If the file exceeds maxSize, it is renamed to <path>.old and a new file is started.
+         */
+        class FileSink : public Sink
+        {
+          private:
+            std::string _path;
+            uint32_t _maxSize = 0;
+            uint8_t* _buffer = nullptr;
+            uint8_t* _writeBuffer = nullptr;
+            volatile uint16_t _length = 0;
+            uint32_t _lastWrite = 0;
+            uint32_t _dropped = 0;
+            void writeFile(const uint8_t* data, uint16_t size);
+
+          protected:
+            void writeOutput(const uint8_t* data, size_t size) override;
+
+          public:
+            FileSink(const char* path, uint32_t maxSize, uint8_t level);
+            const char* name() override;
+            void loop() override;
+            void flush() override;
+            void show() override;
+        };
+    } // namespace Log
+} // namespace OpenKNX
+#endif
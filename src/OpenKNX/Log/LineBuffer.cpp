@@ -0,0 +1,50 @@
+#include "OpenKNX/Log/LineBuffer.h"
+
+namespace OpenKNX
+{
+    namespace Log
+    {
+        LineBuffer::LineBuffer(uint16_t capacity)
+        {
+            _capacity = capacity;
+            _buffer = new uint8_t[capacity];
+        }
+
+        size_t LineBuffer::write(uint8_t byte)
+        {
+            if (_length >= _capacity)
+                return 0;
+
+            _buffer[_length++] = byte;
+            return 1;
+        }
+
+        size_t LineBuffer::write(const uint8_t* data, size_t size)
+        {
+            size = MIN(size, (size_t)(_capacity - _length));
+            memcpy(_buffer + _length, data, size);
+            _length += size;
+            return size;
+        }
+
+        void LineBuffer::clear()
+        {
+            _length = 0;
+        }
+
+        uint16_t LineBuffer::available()
+        {
+            return _capacity - _length;
+        }
+
+        const uint8_t *LineBuffer::data()
+        {
+            return _buffer;
+        }
+
+        uint16_t LineBuffer::length()
+        {
+            return _length;
+        }
+    } // namespace Log
+} // namespace OpenKNX
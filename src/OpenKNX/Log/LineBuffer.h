@@ -0,0 +1,30 @@
+#pragma once
+#include "Arduino.h"
+
+namespace OpenKNX
+{
+    namespace Log
+    {
+        /*
+         * Collects the output of one log line (truncated at capacity).
+         */
+        class LineBuffer : public Print
+        {
+          private:
+            uint8_t* _buffer = nullptr;
+            uint16_t _capacity = 0;
+            uint16_t _length = 0;
+
+          public:
+            LineBuffer(uint16_t capacity);
+            size_t write(uint8_t byte) override;
+            size_t write(const uint8_t* data, size_t size) override;
+            using Print::write;
+
+            void clear();
+            uint16_t available();
+            const uint8_t* data();
+            uint16_t length();
+        };
+    } // namespace Log
+} // namespace OpenKNX
@@ -5,7 +5,7 @@
     #include "SEGGER_RTT.h"
 #endif
 
-#if defined(OPENKNX_TRACE1) || defined(OPENKNX_TRACE2) || defined(OPENKNX_TRACE3) || defined(OPENKNX_TRACE4) || defined(OPENKNX_TRACE5)
+#ifdef OPENKNX_LOGGER_TRACE_FILTER
     #include <Regexp.h>
 #endif
 
@@ -22,6 +22,22 @@ namespace OpenKNX
 #ifdef OPENKNX_LOGGER_DEVICE
             OPENKNX_LOGGER_DEVICE.begin(115200);
 #endif
+
+#ifdef OPENKNX_TRACE1
+            addTraceFilter(TRACE_STRINGIFY(OPENKNX_TRACE1));
+#endif
+#ifdef OPENKNX_TRACE2
+            addTraceFilter(TRACE_STRINGIFY(OPENKNX_TRACE2));
+#endif
+#ifdef OPENKNX_TRACE3
+            addTraceFilter(TRACE_STRINGIFY(OPENKNX_TRACE3));
+#endif
+#ifdef OPENKNX_TRACE4
+            addTraceFilter(TRACE_STRINGIFY(OPENKNX_TRACE4));
+#endif
+#ifdef OPENKNX_TRACE5
+            addTraceFilter(TRACE_STRINGIFY(OPENKNX_TRACE5));
+#endif
         }
 
         void Logger::begin()
@@ -38,6 +54,271 @@ namespace OpenKNX
 #endif
         }
 
+        void Logger::loop()
+        {
+#if OPENKNX_LOGGER_REPEAT_TIMEOUT > 0
+            if (_repeatCount > 0 && millis() - _repeatTime >= OPENKNX_LOGGER_REPEAT_TIMEOUT)
+            {
+                begin();
+                reportRepeats();
+                end();
+            }
+#endif
+#if OPENKNX_LOGGER_RATE_BURST > 0
+            reportSuppressed(false);
+#endif
+#ifdef OPENKNX_LOGGER_ASYNC
+            _async = true;
+            drain(false);
+#endif
+            for (uint8_t i = 0; i < _sinkCount; i++)
+                _sinks[i]->loop();
+        }
+
+        void Logger::flush()
+        {
+#if OPENKNX_LOGGER_REPEAT_TIMEOUT > 0
+            begin();
+            reportRepeats();
+            end();
+#endif
+#if OPENKNX_LOGGER_RATE_BURST > 0
+            reportSuppressed(true);
+#endif
+#ifdef OPENKNX_LOGGER_ASYNC
+            drain(true);
+#endif
+            for (uint8_t i = 0; i < _sinkCount; i++)
+                _sinks[i]->flush();
+        }
+
+        bool Logger::addSink(Sink* sink)
+        {
+            if (_sinkCount >= OPENKNX_LOGGER_SINKS)
+                return false;
+
+            _sinks[_sinkCount++] = sink;
+            return true;
+        }
+
+        Sink* Logger::sink(const char* name)
+        {
+            for (uint8_t i = 0; i < _sinkCount; i++)
+                if (strcmp(_sinks[i]->name(), name) == 0)
+                    return _sinks[i];
+
+            return nullptr;
+        }
+
+        void Logger::showSinks()
+        {
+            logWithPrefix("Logger", "console: all");
+            for (uint8_t i = 0; i < _sinkCount; i++)
+                logWithPrefixAndValues("Logger", "%s: %s%s", _sinks[i]->name(), levelName(_sinks[i]->level()), _sinks[i]->ansi() ? " (ansi)" : "");
+        }
+
+        void Logger::writeSinks(const uint8_t* data, size_t size, uint8_t level)
+        {
+            for (uint8_t i = 0; i < _sinkCount; i++)
+                if (level >= _sinks[i]->level())
+                    _sinks[i]->write(data, size);
+        }
+
+        void Logger::writeSinks(const uint8_t* data, size_t size, uint8_t level, bool immediate)
+        {
+            for (uint8_t i = 0; i < _sinkCount; i++)
+                if (level >= _sinks[i]->level() && _sinks[i]->immediate() == immediate)
+                    _sinks[i]->write(data, size);
+        }
+
+        /*
+         * Writes the collected line to the sinks and to the device (with console sequences and prompt)
+         */
+        void Logger::writeLine(bool complete)
+        {
+            writeSinks(_line.data() + _lineStart, _line.length() - _lineStart, STATE_BY_CORE(_level));
+            if (complete)
+                printPrompt(_line);
+
+            OPENKNX_LOGGER_DEVICE.write(_line.data(), _line.length());
+            _line.clear();
+            _lineStart = 0;
+        }
+
+#ifdef OPENKNX_LOGGER_ASYNC
+        /*
+         * Claims the ring as its only consumer. loop() and flush() may run on different cores,
+         * or flush() in an interrupt of a drain on the same core (which would never continue while waiting).
+         */
+        bool Logger::beginDrain(bool wait)
+        {
+    #ifdef ARDUINO_ARCH_RP2040
+            const uint8_t core = rp2040.cpuid();
+    #else
+            const uint8_t core = 0;
+    #endif
+            while (true)
+            {
+                begin();
+                const uint8_t drainCore = _drainCore;
+                if (drainCore == LOGGER_NO_CORE)
+                    _drainCore = core;
+                end();
+
+                if (drainCore == LOGGER_NO_CORE)
+                    return true;
+
+                if (!wait || drainCore == core)
+                    return false;
+            }
+        }
+
+        void Logger::drain(bool all)
+        {
+            if (_ring.empty() && _dropped == _droppedReported)
+                return;
+
+            if (!beginDrain(all))
+                return;
+
+            const uint32_t start = micros();
+            uint8_t buffer[OPENKNX_LOGGER_LINE_LENGTH];
+            uint16_t length = 0;
+
+            uint8_t type = LOGGER_RECORD_TEXT;
+
+            clearPreviouseLine();
+            while ((all || micros() - start < OPENKNX_LOGGER_ASYNC_BUDGET) && (length = _ring.pop(buffer, OPENKNX_LOGGER_LINE_LENGTH, type)) > 0)
+            {
+    #ifdef OPENKNX_LOGGER_BINARY
+                if ((type & LOGGER_RECORD_MASK) == LOGGER_RECORD_BINARY)
+                {
+                    writeBinary(buffer, length);
+                    continue;
+                }
+    #endif
+                // immediate sinks got the line in afterLog
+                writeSinks(buffer, length, type >> 4, false);
+                OPENKNX_LOGGER_DEVICE.write(buffer, length);
+            }
+
+            // report lost lines after all lines before
+            const uint32_t dropped = _dropped;
+            if (_ring.empty() && dropped != _droppedReported)
+            {
+                OPENKNX_LOGGER_DEVICE.print("Logger: ");
+                OPENKNX_LOGGER_DEVICE.print((int)(dropped - _droppedReported));
+                OPENKNX_LOGGER_DEVICE.print(" lines dropped (increase OPENKNX_LOGGER_ASYNC_SIZE)");
+                OPENKNX_LOGGER_DEVICE.println();
+                _droppedReported = dropped;
+            }
+            printPrompt();
+            _drainCore = LOGGER_NO_CORE;
+        }
+#endif
+
+#ifdef OPENKNX_LOGGER_BINARY
+        /*
+         * Stores a binary record instead of formatting the message.
+         * Returns false if the arguments do not fit into a record.
+         */
+        bool Logger::logBinary(uint8_t logColor, const char* prefix, const char* message, va_list& values)
+        {
+            uint8_t record[OPENKNX_LOGGER_LINE_LENGTH];
+            const uintptr_t format = (uintptr_t)message;
+            const uint32_t time = micros();
+            const uint8_t prefixLength = MIN(strlen(prefix), OPENKNX_MAX_LOG_PREFIX_LENGTH);
+            uint16_t length = 0;
+
+            memcpy(record, &format, sizeof(format));
+            length += sizeof(format);
+            memcpy(record + length, &time, sizeof(time));
+            length += sizeof(time);
+            record[length++] = STATE_BY_CORE(_level);
+            record[length++] = logColor;
+            record[length++] = getIndent();
+    #ifdef ARDUINO_ARCH_RP2040
+            record[length++] = rp2040.cpuid();
+    #else
+            record[length++] = 0;
+    #endif
+            record[length++] = prefixLength;
+            memcpy(record + length, prefix, prefixLength);
+            length += prefixLength;
+
+            // keep values for the formatted fallback
+            va_list copy;
+            va_copy(copy, values);
+            const int32_t argumentsLength = binaryEncodeArguments(record + length, OPENKNX_LOGGER_LINE_LENGTH - length, message, copy);
+            va_end(copy);
+            if (argumentsLength < 0)
+                return false;
+
+            begin();
+    #if OPENKNX_LOGGER_REPEAT_TIMEOUT > 0
+            // all except the time
+            const uint32_t key = hash(record + sizeof(format) + sizeof(time), length + argumentsLength - sizeof(format) - sizeof(time), hash(record, sizeof(format)));
+            if (repeated(key, prefix))
+            {
+                end();
+                return true;
+            }
+    #endif
+            if (!_ring.push(record, length + argumentsLength, LOGGER_RECORD_BINARY))
+                _dropped++;
+            _lines++;
+            end();
+            return true;
+        }
+
+        void Logger::writeBinary(const uint8_t* record, uint16_t size)
+        {
+    #ifdef OPENKNX_LOGGER_BINARY_OUTPUT
+            // formatted on the host (and only for sinks on the device)
+            const uint8_t header[3] = {0, (uint8_t)(size & 0xFF), (uint8_t)(size >> 8)};
+            OPENKNX_LOGGER_DEVICE.write(header, 3);
+            OPENKNX_LOGGER_DEVICE.write(record, size);
+            if (_sinkCount == 0)
+                return;
+    #endif
+            uintptr_t format = 0;
+            uint16_t position = 0;
+            memcpy(&format, record, sizeof(format));
+            position += sizeof(format) + 4; // skip time
+            const uint8_t level = record[position++];
+            const uint8_t logColor = record[position++];
+            const uint8_t indent = record[position++];
+            const uint8_t core = record[position++];
+            const uint8_t prefixLength = record[position++];
+            char prefix[OPENKNX_MAX_LOG_PREFIX_LENGTH + 1] = {};
+            memcpy(prefix, record + position, prefixLength);
+            position += prefixLength;
+
+            _drainLine.clear();
+            if (logColor)
+                printColorCode(_drainLine, logColor);
+            printCore(_drainLine, core);
+            printPrefix(_drainLine, prefix);
+            printIndent(_drainLine, indent);
+            binaryFormatArguments(_drainLine, (const char*)format, record + position, size - position);
+            if (logColor)
+                printColorCode(_drainLine, 0);
+            _drainLine.println();
+            writeSinks(_drainLine.data(), _drainLine.length(), level);
+    #ifndef OPENKNX_LOGGER_BINARY_OUTPUT
+            OPENKNX_LOGGER_DEVICE.write(_drainLine.data(), _drainLine.length());
+    #endif
+        }
+#endif
+
+        Print& Logger::output()
+        {
+            if (_lineActive)
+                return _line;
+
+            return OPENKNX_LOGGER_DEVICE;
+        }
+
         void Logger::color(uint8_t color)
         {
             STATE_BY_CORE(_color) = color;
@@ -50,8 +331,8 @@ namespace OpenKNX
 
         std::string Logger::buildPrefix(const char* prefix, const char* id)
         {
-            char buffer[OPENKNX_MAX_LOG_PREFIX_LENGTH] = {};
-            sprintf(buffer, "%s<%s>", prefix, id);
+            Prefix buffer;
+            buffer.set(prefix, id);
             return std::string(buffer);
         }
 
@@ -62,15 +343,25 @@ namespace OpenKNX
 
         std::string Logger::buildPrefix(const char* prefix, const int id)
         {
-            char buffer[OPENKNX_MAX_LOG_PREFIX_LENGTH] = {};
-            sprintf(buffer, "%s<%i>", prefix, id);
+            Prefix buffer;
+            buffer.set(prefix, id);
             return std::string(buffer);
         }
 
         void Logger::beforeLog()
         {
             begin();
-            clearPreviouseLine();
+            _line.clear();
+            _lineActive = true;
+            _lineStart = 0;
+#ifdef OPENKNX_LOGGER_ASYNC
+            if (!_async)
+#endif
+            {
+                clearPreviouseLine(_line);
+                _lineStart = _line.length();
+            }
+
             if (isColorSet())
                 printColorCode();
             printCore();
@@ -80,8 +371,21 @@ namespace OpenKNX
         {
             if (isColorSet())
                 printColorCode(0);
-            OPENKNX_LOGGER_DEVICE.println();
-            printPrompt();
+            _line.println();
+            _lineActive = false;
+            _lines++;
+#ifdef OPENKNX_LOGGER_ASYNC
+            if (_async)
+            {
+                writeSinks(_line.data(), _line.length(), STATE_BY_CORE(_level), true);
+                // never wait for the device - the line is lost if the ring is full
+                if (!_ring.push(_line.data(), _line.length(), STATE_BY_CORE(_level) << 4 | LOGGER_RECORD_TEXT))
+                    _dropped++;
+            }
+            else
+#endif
+                // line and prompt with one write
+                writeLine(true);
             end();
         }
 
@@ -206,18 +510,354 @@ namespace OpenKNX
 
         void Logger::logMacroWrapper(uint8_t logColor, const char* prefix, const char* message, va_list& values)
         {
-            color(logColor);
-            const char* found = strchr(message, '%');
-            if (found != NULL)
+#ifdef OPENKNX_LOGGER_BINARY
+            // formatting is deferred to drain
+            if (_async && strchr(message, '%') != NULL && OPENKNX_LOGGER_CONSTANT_STRING(message) && logBinary(logColor, prefix, message, values))
+                return;
+#endif
+
+            begin();
+            // format first to detect repeated lines
+            const char* text = message;
+            if (strchr(message, '%') != NULL)
             {
-                logWithPrefixAndValues(prefix, message, values);
+                const uint16_t len = vsnprintf(_buffer, OPENKNX_MAX_LOG_MESSAGE_LENGTH, message, values);
+                if (len >= OPENKNX_MAX_LOG_MESSAGE_LENGTH)
+                    openknx.hardware.fatalError(FATAL_SYSTEM, "BufferOverflow: increase OPENKNX_MAX_LOG_MESSAGE_LENGTH");
+                text = _buffer;
             }
-            else
+
+#if OPENKNX_LOGGER_REPEAT_TIMEOUT > 0
+            const uint8_t level = STATE_BY_CORE(_level);
+            const uint32_t key = hash(text, strlen(text), hash(prefix, strlen(prefix), hash(&level, 1)));
+            if (!repeated(key, prefix))
+#endif
+            {
+                color(logColor);
+                logWithPrefix(prefix, text);
+                color(0);
+            }
+            end();
+        }
+
+        void Logger::logLevelWrapper(uint8_t level, const char* prefix, const char* message, ...)
+        {
+            if (!checkLevel(level, prefix) || !checkRate(level, prefix, message))
+                return;
+
+            va_list values;
+            va_start(values, message);
+            STATE_BY_CORE(_level) = level;
+            logMacroWrapper(levelColor(level), prefix, message, values);
+            STATE_BY_CORE(_level) = LOGGER_LEVEL_INFO;
+            va_end(values);
+        }
+
+        void Logger::logLevelWrapper(uint8_t level, const std::string& prefix, const char* message, ...)
+        {
+            if (!checkLevel(level, prefix.c_str()) || !checkRate(level, prefix.c_str(), message))
+                return;
+
+            va_list values;
+            va_start(values, message);
+            STATE_BY_CORE(_level) = level;
+            logMacroWrapper(levelColor(level), prefix.c_str(), message, values);
+            STATE_BY_CORE(_level) = LOGGER_LEVEL_INFO;
+            va_end(values);
+        }
+
+        void Logger::logLevelWrapper(uint8_t level, const std::string& prefix, const std::string& message, ...)
+        {
+            // the content identifies the call site (the address of a temporary string is not stable)
+            if (!checkLevel(level, prefix.c_str()) || !checkRate(level, prefix.c_str(), hash(message.data(), message.size())))
+                return;
+
+            va_list values;
+            va_start(values, message);
+            STATE_BY_CORE(_level) = level;
+            logMacroWrapper(levelColor(level), prefix.c_str(), message.c_str(), values);
+            STATE_BY_CORE(_level) = LOGGER_LEVEL_INFO;
+            va_end(values);
+        }
+
+        void Logger::logHexLevelWrapper(uint8_t level, const std::string& prefix, const uint8_t* data, size_t size)
+        {
+            logHexLevelWrapper(level, prefix.c_str(), data, size);
+        }
+
+        void Logger::logHexLevelWrapper(uint8_t level, const char* prefix, const uint8_t* data, size_t size)
+        {
+            if (!checkLevel(level, prefix) || !checkRate(level, prefix, nullptr))
+                return;
+
+            STATE_BY_CORE(_level) = level;
+            logHexMacroWrapper(levelColor(level), prefix, data, size);
+            STATE_BY_CORE(_level) = LOGGER_LEVEL_INFO;
+        }
+
+        uint8_t Logger::levelColor(uint8_t level)
+        {
+            switch (level)
+            {
+                case LOGGER_LEVEL_ERROR:
+                    return 31;
+                case LOGGER_LEVEL_INFO:
+                    return 0;
+                default:
+                    return 90;
+            }
+        }
+
+        bool Logger::checkLevel(uint8_t level, const char* prefix)
+        {
+            if (level >= this->level(prefix))
+                return true;
+
+#ifdef OPENKNX_LOGGER_TRACE_FILTER
+            // traces of matching prefixes are shown independent of the level
+            if (level == LOGGER_LEVEL_TRACE)
+                return checkTrace(prefix);
+#endif
+
+            return false;
+        }
+
+        /*
+         * Generic cell rate: each line moves the time of the site by OPENKNX_LOGGER_RATE_INTERVAL,
+         * lines are suppressed while this time is more than the burst ahead.
+         * The address of the message (format string) identifies the call site.
+         * Indented lines belong to a listing (e.g. console output) and are never suppressed.
+         */
+        bool Logger::checkRate(uint8_t level, const char* prefix, const void* site)
+        {
+            return checkRate(level, prefix, hash(&site, sizeof(site)));
+        }
+
+        bool Logger::checkRate(uint8_t level, const char* prefix, uint32_t site)
+        {
+#if OPENKNX_LOGGER_RATE_BURST > 0
+            // traces are explicitly requested by filters
+            if (level == LOGGER_LEVEL_TRACE || getIndent() > 0)
+                return true;
+
+            const uint32_t key = hash(prefix, strlen(prefix), site);
+            const uint32_t now = millis();
+
+            begin();
+            RateSite& entry = _rateSites[key & (OPENKNX_LOGGER_RATE_SITES - 1)];
+            if (entry.key != key)
+            {
+                // replace the previous site
+                reportSuppressed(entry);
+                entry.key = key;
+                entry.time = now;
+                entry.level = level;
+                entry.prefix.set(prefix);
+            }
+
+            if ((int32_t)(entry.time - now) < 0)
+                entry.time = now;
+
+            if (entry.time - now > (uint32_t)(OPENKNX_LOGGER_RATE_BURST - 1) * OPENKNX_LOGGER_RATE_INTERVAL)
             {
-                logWithPrefix(prefix, message);
+                if (entry.suppressed < UINT16_MAX)
+                    entry.suppressed++;
+                end();
+                return false;
             }
 
+            entry.time += OPENKNX_LOGGER_RATE_INTERVAL;
+            reportSuppressed(entry);
+            end();
+#endif
+            return true;
+        }
+
+#if OPENKNX_LOGGER_RATE_BURST > 0
+        /*
+         * Reports the suppressed lines of all sites which may log again (or of all sites)
+         */
+        void Logger::reportSuppressed(bool all)
+        {
+            const uint32_t now = millis();
+
+            begin();
+            for (uint8_t i = 0; i < OPENKNX_LOGGER_RATE_SITES; i++)
+            {
+                RateSite& entry = _rateSites[i];
+                if (entry.suppressed > 0 && (all || (int32_t)(entry.time - now) <= (int32_t)((OPENKNX_LOGGER_RATE_BURST - 1) * OPENKNX_LOGGER_RATE_INTERVAL)))
+                    reportSuppressed(entry);
+            }
+            end();
+        }
+
+        void Logger::reportSuppressed(RateSite& entry)
+        {
+            if (entry.suppressed == 0)
+                return;
+
+            char message[40];
+            snprintf(message, sizeof(message), "%u similar lines suppressed", entry.suppressed);
+            entry.suppressed = 0;
+
+            const uint8_t level = STATE_BY_CORE(_level);
+            STATE_BY_CORE(_level) = entry.level;
+            color(levelColor(entry.level));
+            logWithPrefix(entry.prefix.c_str(), message);
             color(0);
+            STATE_BY_CORE(_level) = level;
+        }
+#endif
+
+#if OPENKNX_LOGGER_REPEAT_TIMEOUT > 0
+        /*
+         * Counts the line if it is the same as the last line (checked with the lock)
+         */
+        bool Logger::repeated(uint32_t key, const char* prefix)
+        {
+            if (key == _repeatKey && _lines == _repeatLine && _repeatCount < UINT16_MAX)
+            {
+                _repeatCount++;
+                _repeatTime = millis();
+                return true;
+            }
+
+            reportRepeats();
+            _repeatKey = key;
+            _repeatLine = _lines + 1;
+            _repeatLevel = STATE_BY_CORE(_level);
+            _repeatPrefix.set(prefix);
+            return false;
+        }
+
+        void Logger::reportRepeats()
+        {
+            if (_repeatCount == 0)
+                return;
+
+            char message[40];
+            snprintf(message, sizeof(message), "last message repeated %u times", _repeatCount);
+            _repeatCount = 0;
+
+            const uint8_t level = STATE_BY_CORE(_level);
+            STATE_BY_CORE(_level) = _repeatLevel;
+            color(levelColor(_repeatLevel));
+            logWithPrefix(_repeatPrefix.c_str(), message);
+            color(0);
+            STATE_BY_CORE(_level) = level;
+            // the next line is no repeat anymore
+            _repeatKey = 0;
+        }
+#endif
+
+        // FNV-1a
+        uint32_t Logger::hash(const void* data, size_t size, uint32_t hash)
+        {
+            const uint8_t* bytes = (const uint8_t*)data;
+            for (size_t i = 0; i < size; i++)
+                hash = (hash ^ bytes[i]) * 16777619;
+
+            return hash;
+        }
+
+        uint8_t Logger::level(const char* prefix)
+        {
+            uint8_t result = _defaultLevel;
+            size_t matched = 0;
+            for (uint8_t i = 0; i < _levelCount; i++)
+            {
+                const size_t length = strlen(_levels[i].prefix);
+                if (length >= matched && strncmp(prefix, _levels[i].prefix, length) == 0)
+                {
+                    result = _levels[i].level;
+                    matched = length;
+                }
+            }
+
+            return result;
+        }
+
+        void Logger::level(uint8_t level)
+        {
+            _defaultLevel = level;
+            updateMinimumLevel();
+        }
+
+        bool Logger::level(const char* prefix, uint8_t level)
+        {
+            uint8_t i = 0;
+            while (i < _levelCount && strcmp(_levels[i].prefix, prefix) != 0)
+                i++;
+
+            if (level == LOGGER_LEVEL_DEFAULT)
+            {
+                // remove
+                if (i < _levelCount)
+                    _levels[i] = _levels[--_levelCount];
+            }
+            else
+            {
+                if (i == OPENKNX_LOGGER_LEVELS)
+                    return false;
+
+                if (i == _levelCount)
+                    _levelCount++;
+
+                strncpy(_levels[i].prefix, prefix, OPENKNX_MAX_LOG_PREFIX_LENGTH);
+                _levels[i].prefix[OPENKNX_MAX_LOG_PREFIX_LENGTH] = 0;
+                _levels[i].level = level;
+            }
+
+            updateMinimumLevel();
+            return true;
+        }
+
+        void Logger::updateMinimumLevel()
+        {
+            uint8_t minimum = _defaultLevel;
+            for (uint8_t i = 0; i < _levelCount; i++)
+                minimum = MIN(minimum, _levels[i].level);
+
+#ifdef OPENKNX_LOGGER_TRACE_FILTER
+            if (_traceFilterCount > 0)
+                minimum = LOGGER_LEVEL_TRACE;
+#endif
+            _minimumLevel = minimum;
+        }
+
+        void Logger::showLevels()
+        {
+            logWithPrefixAndValues("Logger", "Default level: %s (compiled from %s)", levelName(_defaultLevel), levelName(OPENKNX_LOGGER_LEVEL_MIN));
+            for (uint8_t i = 0; i < _levelCount; i++)
+                logWithPrefixAndValues("Logger", "  %s*: %s", _levels[i].prefix, levelName(_levels[i].level));
+        }
+
+        const char* Logger::levelName(uint8_t level)
+        {
+            switch (level)
+            {
+                case LOGGER_LEVEL_TRACE:
+                    return "trace";
+                case LOGGER_LEVEL_DEBUG:
+                    return "debug";
+                case LOGGER_LEVEL_INFO:
+                    return "info";
+                case LOGGER_LEVEL_ERROR:
+                    return "error";
+                case LOGGER_LEVEL_NONE:
+                    return "none";
+                default:
+                    return "default";
+            }
+        }
+
+        uint8_t Logger::levelByName(const char* name)
+        {
+            for (uint8_t level = LOGGER_LEVEL_TRACE; level <= LOGGER_LEVEL_NONE; level++)
+                if (strcmp(name, levelName(level)) == 0)
+                    return level;
+
+            return LOGGER_LEVEL_DEFAULT;
         }
 
         void Logger::logHexMacroWrapper(uint8_t logColor, const std::string& prefix, const uint8_t* data, size_t size)
@@ -239,9 +879,20 @@ namespace OpenKNX
 
         void Logger::printColorCode(uint8_t color)
         {
-            OPENKNX_LOGGER_DEVICE.print("\x1B[");
-            OPENKNX_LOGGER_DEVICE.print((int)color);
-            OPENKNX_LOGGER_DEVICE.print("m");
+            printColorCode(output(), color);
+        }
+
+        void Logger::printColorCode(Print& out, uint8_t color)
+        {
+            uint8_t code[6] = {0x1B, '['};
+            uint8_t length = 2;
+            if (color >= 100)
+                code[length++] = '0' + color / 100;
+            if (color >= 10)
+                code[length++] = '0' + color / 10 % 10;
+            code[length++] = '0' + color % 10;
+            code[length++] = 'm';
+            out.write(code, length);
         }
 
         void Logger::printColorCode()
@@ -251,68 +902,113 @@ namespace OpenKNX
 
         void Logger::printHex(const uint8_t* data, size_t size)
         {
+            static const char digits[] = "0123456789ABCDEF";
+            Print& out = output();
+            uint8_t chunk[48];
+            uint8_t length = 0;
             for (size_t i = 0; i < size; i++)
             {
-                if (data[i] < 0x10)
-                    OPENKNX_LOGGER_DEVICE.print("0");
+                chunk[length++] = digits[data[i] >> 4];
+                chunk[length++] = digits[data[i] & 0x0F];
+                chunk[length++] = ' ';
+                if (length == sizeof(chunk))
+                {
+                    out.write(chunk, length);
+                    length = 0;
 
-                OPENKNX_LOGGER_DEVICE.print(data[i], HEX);
-                OPENKNX_LOGGER_DEVICE.print(" ");
+                    // keep space for color reset and line end
+                    if (_lineActive && _line.available() < sizeof(chunk) + 8)
+                    {
+#ifdef OPENKNX_LOGGER_ASYNC
+                        // truncated in the ring
+                        if (_async)
+                            return;
+#endif
+                        // long dumps are written in parts
+                        writeLine(false);
+                    }
+                }
             }
+
+            if (length > 0)
+                out.write(chunk, length);
         }
 
         void Logger::clearPreviouseLine()
         {
+            begin();
+            clearPreviouseLine(OPENKNX_LOGGER_DEVICE);
+            end();
+        }
+
+        void Logger::clearPreviouseLine(Print& out)
+        {
 #ifndef OPENKNX_RTT
+            static const uint8_t backspaces[16] = {'\b', '\b', '\b', '\b', '\b', '\b', '\b', '\b', '\b', '\b', '\b', '\b', '\b', '\b', '\b', '\b'};
             while (_lastConsoleLen > 0)
             {
-                _lastConsoleLen--;
-                OPENKNX_LOGGER_DEVICE.print("\b");
+                const uint8_t length = MIN(_lastConsoleLen, (uint8_t)sizeof(backspaces));
+                out.write(backspaces, length);
+                _lastConsoleLen -= length;
             }
-            OPENKNX_LOGGER_DEVICE.print("\33[K");
+            out.print("\33[K");
 #endif
         }
 
         void Logger::printPrompt()
         {
+            begin();
+            printPrompt(OPENKNX_LOGGER_DEVICE);
+            end();
+        }
+
+        void Logger::printPrompt(Print& out)
+        {
 #ifndef OPENKNX_RTT
-            clearPreviouseLine();
-            OPENKNX_LOGGER_DEVICE.print(openknx.console.prompt);
+            clearPreviouseLine(out);
+            out.print(openknx.console.prompt);
             _lastConsoleLen = strlen(openknx.console.prompt);
 #endif
         }
 
         void Logger::printPrefix(const char* prefix)
         {
-            size_t prefixLen = MIN(strlen(prefix), OPENKNX_MAX_LOG_PREFIX_LENGTH);
-            for (size_t i = 0; i < (OPENKNX_MAX_LOG_PREFIX_LENGTH + 2); i++)
+            printPrefix(output(), prefix);
+        }
+
+        void Logger::printPrefix(Print& out, const char* prefix)
+        {
+            const size_t prefixLen = MIN(strlen(prefix), OPENKNX_MAX_LOG_PREFIX_LENGTH);
+            size_t padding = OPENKNX_MAX_LOG_PREFIX_LENGTH + 2 - prefixLen;
+            out.write((const uint8_t*)prefix, prefixLen);
+            if (prefixLen > 0)
             {
-                if (i < prefixLen)
-                {
-                    OPENKNX_LOGGER_DEVICE.print(prefix[i]);
-                }
-                else if (i == prefixLen && prefixLen > 0)
-                {
-                    OPENKNX_LOGGER_DEVICE.print(":");
-                }
-                else
-                {
-                    OPENKNX_LOGGER_DEVICE.print(" ");
-                }
+                out.write(':');
+                padding--;
             }
+            printSpaces(out, padding);
         }
 
         void Logger::printCore()
         {
+#ifdef ARDUINO_ARCH_RP2040
+            printCore(output(), rp2040.cpuid());
+#else
+            printCore(output(), 0);
+#endif
+        }
+
+        void Logger::printCore(Print& out, uint8_t core)
+        {
 #if defined(ARDUINO_ARCH_RP2040) && (defined(OPENKNX_DEBUG) || defined(OPENKNX_LOGGER_SHOWCORE))
             if (openknx.usesDualCore())
-                OPENKNX_LOGGER_DEVICE.print(rp2040.cpuid() ? "_1> " : "0_> ");
+                out.print(core ? "_1> " : "0_> ");
 #endif
         }
 
         void Logger::printMessage(const char* message)
         {
-            OPENKNX_LOGGER_DEVICE.print(message);
+            output().print(message);
         }
 
         void Logger::printMessage(const char* message, va_list& values)
@@ -320,51 +1016,96 @@ namespace OpenKNX
             const char* found = strchr(message, '%');
             if (found == NULL)
             {
-                OPENKNX_LOGGER_DEVICE.print(message);
+                output().print(message);
                 return;
             }
 
             memset(_buffer, 0, OPENKNX_MAX_LOG_MESSAGE_LENGTH);
             uint16_t len = vsnprintf(_buffer, OPENKNX_MAX_LOG_MESSAGE_LENGTH, message, values);
-            OPENKNX_LOGGER_DEVICE.print(_buffer);
+            output().print(_buffer);
             if (len >= OPENKNX_MAX_LOG_MESSAGE_LENGTH)
                 openknx.hardware.fatalError(FATAL_SYSTEM, "BufferOverflow: increase OPENKNX_MAX_LOG_MESSAGE_LENGTH");
         }
 
-#if defined(OPENKNX_TRACE1) || defined(OPENKNX_TRACE2) || defined(OPENKNX_TRACE3) || defined(OPENKNX_TRACE4) || defined(OPENKNX_TRACE5)
-        bool Logger::checkTrace(const std::string& prefix)
+#ifdef OPENKNX_LOGGER_TRACE_FILTER
+        bool Logger::checkTrace(const char* prefix)
+        {
+            if (_traceFilterCount == 0)
+                return false;
+
+            const uint32_t hash = this->hash(prefix, strlen(prefix));
+            const uint32_t key = (hash & ~(uint32_t)3) | 2;
+            volatile uint32_t& entry = _traceCache[hash & (OPENKNX_LOGGER_TRACE_CACHE - 1)];
+            const uint32_t cached = entry;
+            if ((cached & ~(uint32_t)1) == key)
+                return cached & 1;
+
+            const bool match = matchTrace(prefix);
+            entry = key | (match ? 1 : 0);
+            return match;
+        }
+
+        bool Logger::matchTrace(const char* prefix)
         {
             MatchState ms;
-            ms.Target((char*)prefix.c_str());
-    #ifdef OPENKNX_TRACE1
-            if (strlen(TRACE_STRINGIFY(OPENKNX_TRACE1)) > 0 && ms.MatchCount(TRACE_STRINGIFY(OPENKNX_TRACE1)) > 0)
-                return true;
-    #endif
-    #ifdef OPENKNX_TRACE2
-            if (strlen(TRACE_STRINGIFY(OPENKNX_TRACE2)) > 0 && ms.MatchCount(TRACE_STRINGIFY(OPENKNX_TRACE2)) > 0)
-                return true;
-    #endif
-    #ifdef OPENKNX_TRACE3
-            if (strlen(TRACE_STRINGIFY(OPENKNX_TRACE3)) > 0 && ms.MatchCount(TRACE_STRINGIFY(OPENKNX_TRACE3)) > 0)
-                return true;
-    #endif
-    #ifdef OPENKNX_TRACE4
-            if (strlen(TRACE_STRINGIFY(OPENKNX_TRACE4)) > 0 && ms.MatchCount(TRACE_STRINGIFY(OPENKNX_TRACE4)) > 0)
-                return true;
-    #endif
-    #ifdef OPENKNX_TRACE5
-            if (strlen(TRACE_STRINGIFY(OPENKNX_TRACE5)) > 0 && ms.MatchCount(TRACE_STRINGIFY(OPENKNX_TRACE5)))
-                return true;
-    #endif
+            ms.Target((char*)prefix);
+            for (uint8_t i = 0; i < _traceFilterCount; i++)
+                if (ms.MatchCount(_traceFilters[i]) > 0)
+                    return true;
 
             return false;
         }
+
+        bool Logger::addTraceFilter(const char* filter)
+        {
+            if (strlen(filter) == 0)
+                return true;
+
+            if (_traceFilterCount >= OPENKNX_LOGGER_TRACE_FILTERS || strlen(filter) > OPENKNX_LOGGER_TRACE_FILTER_LENGTH)
+                return false;
+
+            strcpy(_traceFilters[_traceFilterCount++], filter);
+            memset((void*)_traceCache, 0, sizeof(_traceCache));
+            updateMinimumLevel();
+            return true;
+        }
+
+        void Logger::clearTraceFilters()
+        {
+            _traceFilterCount = 0;
+            memset((void*)_traceCache, 0, sizeof(_traceCache));
+            updateMinimumLevel();
+        }
+
+        void Logger::showTraceFilters()
+        {
+            if (_traceFilterCount == 0)
+                logWithPrefix("Logger", "No trace filter");
+
+            for (uint8_t i = 0; i < _traceFilterCount; i++)
+                logWithPrefixAndValues("Logger", "Trace filter %i: %s", i + 1, _traceFilters[i]);
+        }
 #endif
 
         void Logger::printIndent()
         {
-            for (size_t i = 0; i < getIndent(); i++)
-                OPENKNX_LOGGER_DEVICE.print("  ");
+            printIndent(output(), getIndent());
+        }
+
+        void Logger::printIndent(Print& out, uint8_t indent)
+        {
+            printSpaces(out, indent * 2);
+        }
+
+        void Logger::printSpaces(Print& out, size_t count)
+        {
+            static const uint8_t spaces[16] = {' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' '};
+            while (count > 0)
+            {
+                const size_t length = MIN(count, sizeof(spaces));
+                out.write(spaces, length);
+                count -= length;
+            }
         }
 
         void Logger::indentUp()
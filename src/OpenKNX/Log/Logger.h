@@ -22,19 +22,73 @@
     #define OPENKNX_MAX_LOG_MESSAGE_LENGTH 200
 #endif
 
+#include "OpenKNX/Log/LineBuffer.h"
+#include "OpenKNX/Log/Prefix.h"
+#include "OpenKNX/Log/Sink.h"
+
+// complete line with color codes, core, prefix, indent and message
+#ifndef OPENKNX_LOGGER_LINE_LENGTH
+    #define OPENKNX_LOGGER_LINE_LENGTH (OPENKNX_MAX_LOG_PREFIX_LENGTH + OPENKNX_MAX_LOG_MESSAGE_LENGTH + 48)
+#endif
+
+#ifdef OPENKNX_LOGGER_ASYNC
+    #include "OpenKNX/Log/RingBuffer.h"
+
+    #ifndef OPENKNX_LOGGER_ASYNC_SIZE
+        #define OPENKNX_LOGGER_ASYNC_SIZE 8192
+    #endif
+
+    #if OPENKNX_LOGGER_ASYNC_SIZE & (OPENKNX_LOGGER_ASYNC_SIZE - 1)
+        #error "OPENKNX_LOGGER_ASYNC_SIZE must be a power of two"
+    #endif
+
+    #ifndef OPENKNX_LOGGER_ASYNC_BUDGET
+        #define OPENKNX_LOGGER_ASYNC_BUDGET 1000
+    #endif
+
+    // TYPE of a record: LEVEL << 4 | RECORD
+    #define LOGGER_RECORD_TEXT 0
+    #define LOGGER_RECORD_BINARY 1
+    #define LOGGER_RECORD_MASK 0x0F
+
+    #define LOGGER_NO_CORE 0xFF
+#endif
+
+/*
+ * Binary record (formatted on drain or on the host with OPENKNX_LOGGER_BINARY_OUTPUT):
+ * > RECORD := FORMAT[sizeof(void*)] ; TIME[4] ; LEVEL[1] ; COLOR[1] ; INDENT[1] ; CORE[1] ; PREFIX_LEN[1] ; PREFIX ; ARGS (see BinaryLog.h)
+ * Frame on the device with OPENKNX_LOGGER_BINARY_OUTPUT:
+ * > FRAME := 0x00 ; SIZE[2] ; RECORD[SIZE]
+ * FORMAT is the address of the format string (string literal), TIME in µs. All values in native byte order.
+ */
+#ifdef OPENKNX_LOGGER_BINARY
+    #ifndef OPENKNX_LOGGER_ASYNC
+        #error "OPENKNX_LOGGER_BINARY needs OPENKNX_LOGGER_ASYNC"
+    #endif
+    #include "OpenKNX/Log/BinaryLog.h"
+
+    // the format string must still exist on drain, so only string literals (in flash) are stored as binary record
+    #ifndef OPENKNX_LOGGER_CONSTANT_STRING
+        #if defined(ARDUINO_ARCH_RP2040)
+            #define OPENKNX_LOGGER_CONSTANT_STRING(X) ((uintptr_t)(X) >= XIP_BASE && (uintptr_t)(X) < SRAM_BASE)
+        #elif defined(ARDUINO_ARCH_SAMD)
+            #define OPENKNX_LOGGER_CONSTANT_STRING(X) ((uintptr_t)(X) < HMCRAMC0_ADDR)
+        #else
+            #define OPENKNX_LOGGER_CONSTANT_STRING(X) false
+        #endif
+    #endif
+#endif
+
 #define logIndentUp() openknx.logger.indentUp()
 #define logIndentDown() openknx.logger.indentDown()
 #define logIndent(X) openknx.logger.indent(X)
 
-#define logError(...) openknx.logger.logMacroWrapper(31, __VA_ARGS__)
-#define logErrorP(...) openknx.logger.logMacroWrapper(31, logPrefix().c_str(), __VA_ARGS__)
-#define logHexError(...) openknx.logger.logHexMacroWrapper(31, __VA_ARGS__)
-#define logHexErrorP(...) openknx.logger.logHexMacroWrapper(31, logPrefix().c_str(), __VA_ARGS__)
-
-#define logInfo(...) openknx.logger.logMacroWrapper(0, __VA_ARGS__)
-#define logInfoP(...) openknx.logger.logMacroWrapper(0, logPrefix().c_str(), __VA_ARGS__)
-#define logHexInfo(...) openknx.logger.logHexMacroWrapper(0, __VA_ARGS__)
-#define logHexInfoP(...) openknx.logger.logHexMacroWrapper(0, logPrefix().c_str(), __VA_ARGS__)
+#define LOGGER_LEVEL_TRACE 0
+#define LOGGER_LEVEL_DEBUG 1
+#define LOGGER_LEVEL_INFO 2
+#define LOGGER_LEVEL_ERROR 3
+#define LOGGER_LEVEL_NONE 4
+#define LOGGER_LEVEL_DEFAULT 0xFF
 
 #if defined(OPENKNX_TRACE1) || defined(OPENKNX_TRACE2) || defined(OPENKNX_TRACE3) || defined(OPENKNX_TRACE4) || defined(OPENKNX_TRACE5)
 
@@ -59,18 +113,165 @@
     // Force Debug Mode during Trace
     #undef OPENKNX_DEBUG
     #define OPENKNX_DEBUG
-    #define logTrace(prefix, ...)              \
-        if (openknx.logger.checkTrace(prefix)) \
-        openknx.logger.logMacroWrapper(90, prefix, __VA_ARGS__)
-    #define logTraceP(...)                                  \
-        if (openknx.logger.checkTrace(logPrefix().c_str())) \
-        openknx.logger.logMacroWrapper(90, logPrefix().c_str(), __VA_ARGS__)
-    #define logHexTrace(prefix, ...)           \
-        if (openknx.logger.checkTrace(prefix)) \
-        openknx.logger.logHexMacroWrapper(90, prefix, __VA_ARGS__)
-    #define logHexTraceP(...)                               \
-        if (openknx.logger.checkTrace(logPrefix().c_str())) \
-        openknx.logger.logHexMacroWrapper(90, logPrefix().c_str(), __VA_ARGS__)
+    #define OPENKNX_LOGGER_TRACE_FILTER
+#endif
+
+/*
+ * Lowest level compiled into the firmware (all logs below are removed completely)
+ */
+#ifndef OPENKNX_LOGGER_LEVEL_MIN
+    #if defined(OPENKNX_LOGGER_TRACE_FILTER)
+        #define OPENKNX_LOGGER_LEVEL_MIN LOGGER_LEVEL_TRACE
+    #elif defined(OPENKNX_DEBUG)
+        #define OPENKNX_LOGGER_LEVEL_MIN LOGGER_LEVEL_DEBUG
+    #else
+        #define OPENKNX_LOGGER_LEVEL_MIN LOGGER_LEVEL_INFO
+    #endif
+#endif
+
+/*
+ * Level after startup (can be changed per prefix at runtime), traces are additionally shown if they match a trace filter
+ */
+#ifndef OPENKNX_LOGGER_LEVEL
+    #if defined(OPENKNX_DEBUG)
+        #define OPENKNX_LOGGER_LEVEL LOGGER_LEVEL_DEBUG
+    #else
+        #define OPENKNX_LOGGER_LEVEL LOGGER_LEVEL_INFO
+    #endif
+#endif
+
+#ifndef OPENKNX_LOGGER_LEVELS
+    #define OPENKNX_LOGGER_LEVELS 8
+#endif
+
+// max. number of additional outputs (see Sink.h)
+#ifndef OPENKNX_LOGGER_SINKS
+    #define OPENKNX_LOGGER_SINKS 4
+#endif
+
+// size of a sink keeping the last output in RAM (disabled if not defined)
+#ifdef OPENKNX_LOGGER_SINK_MEMORY
+    #ifndef OPENKNX_LOGGER_SINK_MEMORY_LEVEL
+        #define OPENKNX_LOGGER_SINK_MEMORY_LEVEL LOGGER_LEVEL_TRACE
+    #endif
+#endif
+
+// send log lines on the diagnose ko (needs LOG_KoDiagnose)
+#ifdef OPENKNX_LOGGER_SINK_DIAGNOSE
+    #ifndef OPENKNX_LOGGER_SINK_DIAGNOSE_LEVEL
+        #define OPENKNX_LOGGER_SINK_DIAGNOSE_LEVEL LOGGER_LEVEL_ERROR
+    #endif
+#endif
+
+// path of a log file on LittleFS (RP2040 only)
+#ifdef OPENKNX_LOGGER_SINK_FILE
+    #ifndef OPENKNX_LOGGER_SINK_FILE_LEVEL
+        #define OPENKNX_LOGGER_SINK_FILE_LEVEL LOGGER_LEVEL_INFO
+    #endif
+    #ifndef OPENKNX_LOGGER_SINK_FILE_SIZE
+        #define OPENKNX_LOGGER_SINK_FILE_SIZE 65536
+    #endif
+#endif
+
+// size of a sink keeping the last output in RAM over a warm reset (RP2040 only, disabled if not defined)
+#ifdef OPENKNX_LOGGER_SINK_CRASH
+    #ifndef OPENKNX_LOGGER_SINK_CRASH_LEVEL
+        #define OPENKNX_LOGGER_SINK_CRASH_LEVEL LOGGER_LEVEL_TRACE
+    #endif
+#endif
+
+// traces are compiled in, so trace filters can be set at runtime
+#if OPENKNX_LOGGER_LEVEL_MIN <= LOGGER_LEVEL_TRACE && !defined(OPENKNX_LOGGER_TRACE_FILTER)
+    #define OPENKNX_LOGGER_TRACE_FILTER
+#endif
+
+#ifdef OPENKNX_LOGGER_TRACE_FILTER
+    #ifndef OPENKNX_LOGGER_TRACE_FILTERS
+        #define OPENKNX_LOGGER_TRACE_FILTERS 5
+    #endif
+
+    #ifndef OPENKNX_LOGGER_TRACE_FILTER_LENGTH
+        #define OPENKNX_LOGGER_TRACE_FILTER_LENGTH 31
+    #endif
+
+    // match results of trace filters per prefix (power of two)
+    #ifndef OPENKNX_LOGGER_TRACE_CACHE
+        #define OPENKNX_LOGGER_TRACE_CACHE 32
+    #endif
+
+    #if OPENKNX_LOGGER_TRACE_CACHE & (OPENKNX_LOGGER_TRACE_CACHE - 1)
+        #error "OPENKNX_LOGGER_TRACE_CACHE must be a power of two"
+    #endif
+#endif
+
+/*
+ * Optional rate limit per call site and prefix: OPENKNX_LOGGER_RATE_BURST lines at once,
+ * then one line per OPENKNX_LOGGER_RATE_INTERVAL. Traces and indented lines (listings, dumps) are not limited.
+ * The number of suppressed lines is reported as soon as the site may log again. 0 disables the rate limit.
+ */
+#ifndef OPENKNX_LOGGER_RATE_BURST
+    #define OPENKNX_LOGGER_RATE_BURST 0
+#endif
+
+#if OPENKNX_LOGGER_RATE_BURST > 0
+    #ifndef OPENKNX_LOGGER_RATE_INTERVAL // MS
+        #define OPENKNX_LOGGER_RATE_INTERVAL 1000
+    #endif
+
+    // tracked call sites (power of two)
+    #ifndef OPENKNX_LOGGER_RATE_SITES
+        #define OPENKNX_LOGGER_RATE_SITES 32
+    #endif
+
+    #if OPENKNX_LOGGER_RATE_SITES & (OPENKNX_LOGGER_RATE_SITES - 1)
+        #error "OPENKNX_LOGGER_RATE_SITES must be a power of two"
+    #endif
+#endif
+
+/*
+ * Identical consecutive lines are counted and reported as one line with the next different line
+ * or after OPENKNX_LOGGER_REPEAT_TIMEOUT. 0 disables the deduplication.
+ */
+#ifndef OPENKNX_LOGGER_REPEAT_TIMEOUT // MS
+    #define OPENKNX_LOGGER_REPEAT_TIMEOUT 1000
+#endif
+
+// the arguments (and the prefix) are only evaluated if the level is enabled for any prefix
+#define LOGGER_LOG(LEVEL, ...) (openknx.logger.enabled(LEVEL) ? openknx.logger.logLevelWrapper(LEVEL, __VA_ARGS__) : (void)0)
+#define LOGGER_LOG_HEX(LEVEL, ...) (openknx.logger.enabled(LEVEL) ? openknx.logger.logHexLevelWrapper(LEVEL, __VA_ARGS__) : (void)0)
+
+// prefix of the logXxxP macros (see cachedLogPrefix in Prefix.h)
+#define LOGGER_PREFIX cachedLogPrefix([&]() { return logPrefix(); })
+
+#if OPENKNX_LOGGER_LEVEL_MIN <= LOGGER_LEVEL_ERROR
+    #define logError(...) LOGGER_LOG(LOGGER_LEVEL_ERROR, __VA_ARGS__)
+    #define logErrorP(...) LOGGER_LOG(LOGGER_LEVEL_ERROR, LOGGER_PREFIX, __VA_ARGS__)
+    #define logHexError(...) LOGGER_LOG_HEX(LOGGER_LEVEL_ERROR, __VA_ARGS__)
+    #define logHexErrorP(...) LOGGER_LOG_HEX(LOGGER_LEVEL_ERROR, LOGGER_PREFIX, __VA_ARGS__)
+#else
+    #define logError(...)
+    #define logErrorP(...)
+    #define logHexError(...)
+    #define logHexErrorP(...)
+#endif
+
+#if OPENKNX_LOGGER_LEVEL_MIN <= LOGGER_LEVEL_INFO
+    #define logInfo(...) LOGGER_LOG(LOGGER_LEVEL_INFO, __VA_ARGS__)
+    #define logInfoP(...) LOGGER_LOG(LOGGER_LEVEL_INFO, LOGGER_PREFIX, __VA_ARGS__)
+    #define logHexInfo(...) LOGGER_LOG_HEX(LOGGER_LEVEL_INFO, __VA_ARGS__)
+    #define logHexInfoP(...) LOGGER_LOG_HEX(LOGGER_LEVEL_INFO, LOGGER_PREFIX, __VA_ARGS__)
+#else
+    #define logInfo(...)
+    #define logInfoP(...)
+    #define logHexInfo(...)
+    #define logHexInfoP(...)
+#endif
+
+#if OPENKNX_LOGGER_LEVEL_MIN <= LOGGER_LEVEL_TRACE
+    #define logTrace(...) LOGGER_LOG(LOGGER_LEVEL_TRACE, __VA_ARGS__)
+    #define logTraceP(...) LOGGER_LOG(LOGGER_LEVEL_TRACE, LOGGER_PREFIX, __VA_ARGS__)
+    #define logHexTrace(...) LOGGER_LOG_HEX(LOGGER_LEVEL_TRACE, __VA_ARGS__)
+    #define logHexTraceP(...) LOGGER_LOG_HEX(LOGGER_LEVEL_TRACE, LOGGER_PREFIX, __VA_ARGS__)
 #else
     #define logTrace(...)
     #define logTraceP(...)
@@ -78,11 +279,11 @@
     #define logHexTraceP(...)
 #endif
 
-#ifdef OPENKNX_DEBUG
-    #define logDebug(...) openknx.logger.logMacroWrapper(90, __VA_ARGS__)
-    #define logDebugP(...) openknx.logger.logMacroWrapper(90, logPrefix().c_str(), __VA_ARGS__)
-    #define logHexDebug(...) openknx.logger.logHexMacroWrapper(90, __VA_ARGS__)
-    #define logHexDebugP(...) openknx.logger.logHexMacroWrapper(90, logPrefix().c_str(), __VA_ARGS__)
+#if OPENKNX_LOGGER_LEVEL_MIN <= LOGGER_LEVEL_DEBUG
+    #define logDebug(...) LOGGER_LOG(LOGGER_LEVEL_DEBUG, __VA_ARGS__)
+    #define logDebugP(...) LOGGER_LOG(LOGGER_LEVEL_DEBUG, LOGGER_PREFIX, __VA_ARGS__)
+    #define logHexDebug(...) LOGGER_LOG_HEX(LOGGER_LEVEL_DEBUG, __VA_ARGS__)
+    #define logHexDebugP(...) LOGGER_LOG_HEX(LOGGER_LEVEL_DEBUG, LOGGER_PREFIX, __VA_ARGS__)
 #else
     #define logDebug(...)
     #define logDebugP(...)
@@ -123,20 +324,101 @@ namespace OpenKNX
 #ifdef ARDUINO_ARCH_RP2040
             // use individual values per core
             volatile uint8_t _color[2] = {(uint8_t)0, (uint8_t)0};
+            volatile uint8_t _level[2] = {(uint8_t)LOGGER_LEVEL_INFO, (uint8_t)LOGGER_LEVEL_INFO};
             volatile uint8_t _indent[2] = {(uint8_t)0, (uint8_t)0};
             recursive_mutex_t _mutex;
 #else
             uint8_t _color = 0;
+            uint8_t _level = LOGGER_LEVEL_INFO;
             uint8_t _indent = 0;
 #endif
+            // runtime levels per prefix (longest match wins)
+            struct LevelEntry
+            {
+                char prefix[OPENKNX_MAX_LOG_PREFIX_LENGTH + 1];
+                uint8_t level;
+            };
+            LevelEntry _levels[OPENKNX_LOGGER_LEVELS] = {};
+            uint8_t _levelCount = 0;
+            uint8_t _defaultLevel = OPENKNX_LOGGER_LEVEL;
+            uint8_t _minimumLevel = OPENKNX_LOGGER_LEVEL;
+#ifdef OPENKNX_LOGGER_TRACE_FILTER
+            char _traceFilters[OPENKNX_LOGGER_TRACE_FILTERS][OPENKNX_LOGGER_TRACE_FILTER_LENGTH + 1] = {};
+            uint8_t _traceFilterCount = 0;
+            // per prefix hash: (HASH & ~3) | 2 (valid) | 1 (match), one word to be safe for both cores without lock
+            volatile uint32_t _traceCache[OPENKNX_LOGGER_TRACE_CACHE] = {};
+            bool matchTrace(const char* prefix);
+#endif
+            void updateMinimumLevel();
+#if OPENKNX_LOGGER_RATE_BURST > 0
+            struct RateSite
+            {
+                uint32_t key;
+                // theoretical arrival time of the next line
+                uint32_t time;
+                uint16_t suppressed;
+                uint8_t level;
+                // for the report of suppressed lines
+                Prefix prefix;
+            };
+            RateSite _rateSites[OPENKNX_LOGGER_RATE_SITES] = {};
+            void reportSuppressed(bool all);
+            void reportSuppressed(RateSite& entry);
+#endif
+            bool checkRate(uint8_t level, const char* prefix, const void* site);
+            // site as hash (e.g. of the message content)
+            bool checkRate(uint8_t level, const char* prefix, uint32_t site);
+            // number of lines written (to detect lines between repeated lines)
+            uint32_t _lines = 0;
+#if OPENKNX_LOGGER_REPEAT_TIMEOUT > 0
+            uint32_t _repeatKey = 0;
+            uint32_t _repeatLine = 0;
+            uint32_t _repeatTime = 0;
+            uint16_t _repeatCount = 0;
+            uint8_t _repeatLevel = LOGGER_LEVEL_INFO;
+            Prefix _repeatPrefix;
+            bool repeated(uint32_t key, const char* prefix);
+            void reportRepeats();
+#endif
+            static uint32_t hash(const void* data, size_t size, uint32_t hash = 2166136261);
+            uint8_t levelColor(uint8_t level);
+            // each line is assembled and written to the device at once (or pushed to the ring)
+            LineBuffer _line = LineBuffer(OPENKNX_LOGGER_LINE_LENGTH);
+            bool _lineActive = false;
+            // start of the line after the console sequences (only for the device)
+            uint16_t _lineStart = 0;
+            Sink* _sinks[OPENKNX_LOGGER_SINKS] = {};
+            uint8_t _sinkCount = 0;
+            void writeLine(bool complete);
+            void writeSinks(const uint8_t* data, size_t size, uint8_t level);
+            void writeSinks(const uint8_t* data, size_t size, uint8_t level, bool immediate);
+#ifdef OPENKNX_LOGGER_ASYNC
+            // lines are collected in the ring and written in loop (after the first loop)
+            RingBuffer _ring = RingBuffer(OPENKNX_LOGGER_ASYNC_SIZE);
+            bool _async = false;
+            uint32_t _dropped = 0;
+            uint32_t _droppedReported = 0;
+            // core which currently drains the ring (the ring has a single consumer)
+            volatile uint8_t _drainCore = LOGGER_NO_CORE;
+            bool beginDrain(bool wait);
+            void drain(bool all);
+#endif
+#ifdef OPENKNX_LOGGER_BINARY
+            LineBuffer _drainLine = LineBuffer(OPENKNX_LOGGER_LINE_LENGTH);
+            bool logBinary(uint8_t logColor, const char* prefix, const char* message, va_list& values);
+            void writeBinary(const uint8_t* record, uint16_t size);
+#endif
+            Print& output();
             void printHex(const uint8_t* data, size_t size);
             void printMessage(const char* message, va_list& values);
             void printMessage(const char* message);
             void printPrefix(const char* prefix);
+            void printPrefix(Print& out, const char* prefix);
             void logWithValues(const char* message, va_list& values);
             void logWithPrefixAndValues(const char* prefix, const char* message, va_list& values);
             void logMacroWrapper(uint8_t logColor, const char* prefix, const char* message, va_list& values);
             void printCore();
+            void printCore(Print& out, uint8_t core);
             bool isColorSet();
             void beforeLog();
             void afterLog();
@@ -150,8 +432,13 @@ namespace OpenKNX
              * WHITE           7
              */
             void printColorCode(uint8_t color);
+            void printColorCode(Print& out, uint8_t color);
             void printColorCode();
             void printIndent();
+            void printIndent(Print& out, uint8_t indent);
+            void printSpaces(Print& out, size_t count);
+            void printPrompt(Print& out);
+            void clearPreviouseLine(Print& out);
             uint8_t getIndent();
 
           public:
@@ -174,6 +461,25 @@ namespace OpenKNX
              */
             void end();
 
+            /*
+             * Writes collected lines to the device within OPENKNX_LOGGER_ASYNC_BUDGET (only with OPENKNX_LOGGER_ASYNC)
+             */
+            void loop();
+
+            /*
+             * Writes all collected lines to the device and sinks (e.g. before restart)
+             * Should be called on the core which calls loop(). Only one drain runs at a time: from the other core
+             * flush waits for a running drain, in an interrupt of a running drain (same core) the lines stay in the ring.
+             */
+            void flush();
+
+            /*
+             * Add an output beside the device. Each line is formatted once and passed to all sinks with a matching level.
+             */
+            bool addSink(Sink* sink);
+            Sink* sink(const char* name);
+            void showSinks();
+
             std::string buildPrefix(const char* prefix, const char* id);
             std::string buildPrefix(const std::string& prefix, const std::string& id);
             std::string buildPrefix(const char* prefix, const int id);
@@ -201,12 +507,55 @@ namespace OpenKNX
             void logHexMacroWrapper(uint8_t logColor, const char* prefix, const uint8_t* data, size_t size);
             void logHexMacroWrapper(uint8_t logColor, const std::string& prefix, const uint8_t* data, size_t size);
 
+            void logLevelWrapper(uint8_t level, const char* prefix, const char* message, ...);
+            void logLevelWrapper(uint8_t level, const std::string& prefix, const char* message, ...);
+            void logLevelWrapper(uint8_t level, const std::string& prefix, const std::string& message, ...);
+            void logHexLevelWrapper(uint8_t level, const char* prefix, const uint8_t* data, size_t size);
+            void logHexLevelWrapper(uint8_t level, const std::string& prefix, const uint8_t* data, size_t size);
+
+            /*
+             * Fast check if a level is enabled for any prefix (before the prefix is built)
+             */
+            inline bool enabled(uint8_t level)
+            {
+                return level >= _minimumLevel;
+            }
+            bool checkLevel(uint8_t level, const char* prefix);
+
+            /*
+             * Effective level for a prefix
+             */
+            uint8_t level(const char* prefix);
+
+            /*
+             * Set the default level
+             */
+            void level(uint8_t level);
+
+            /*
+             * Set the level for all prefixes starting with prefix (LOGGER_LEVEL_DEFAULT removes it)
+             */
+            bool level(const char* prefix, uint8_t level);
+            void showLevels();
+            static const char* levelName(uint8_t level);
+            static uint8_t levelByName(const char* name);
+
             void indentUp();
             void indentDown();
             void indent(uint8_t indent);
 
-#if defined(OPENKNX_TRACE1) || defined(OPENKNX_TRACE2) || defined(OPENKNX_TRACE3) || defined(OPENKNX_TRACE4) || defined(OPENKNX_TRACE5)
-            bool checkTrace(const std::string& prefix);
+#ifdef OPENKNX_LOGGER_TRACE_FILTER
+            /*
+             * Check if the prefix matches a trace filter (cached per prefix)
+             */
+            bool checkTrace(const char* prefix);
+
+            /*
+             * Add a trace filter (regex of the Regexp library, see https://www.lua.org/pil/20.2.html)
+             */
+            bool addTraceFilter(const char* filter);
+            void clearTraceFilters();
+            void showTraceFilters();
 #endif
             void printPrompt();
             void clearPreviouseLine();
@@ -0,0 +1,56 @@
+#include "OpenKNX/Log/MemorySink.h"
+#include "OpenKNX/Facade.h"
+
+namespace OpenKNX
+{
+    namespace Log
+    {
+        MemorySink::MemorySink(uint32_t capacity, uint8_t level, bool ansi)
+            : Sink(level, ansi)
+        {
+            _capacity = capacity;
+            _buffer = new uint8_t[capacity];
+        }
+
+        const char* MemorySink::name()
+        {
+            return "memory";
+        }
+
+        void MemorySink::writeOutput(const uint8_t* data, size_t size)
+        {
+            while (size > 0)
+            {
+                const uint32_t part = MIN(size, _capacity - _position);
+                memcpy(_buffer + _position, data, part);
+                _position += part;
+                data += part;
+                size -= part;
+                if (_position == _capacity)
+                {
+                    _position = 0;
+                    _wrapped = true;
+                }
+            }
+        }
+
+        void MemorySink::print(Print& out)
+        {
+            if (_wrapped)
+                out.write(_buffer + _position, _capacity - _position);
+
+            out.write(_buffer, _position);
+        }
+
+        void MemorySink::show()
+        {
+            // directly to the device, otherwise the output would be appended while printing
+            openknx.logger.flush();
+            openknx.logger.begin();
+            openknx.logger.clearPreviouseLine();
+            print(OPENKNX_LOGGER_DEVICE);
+            openknx.logger.printPrompt();
+            openknx.logger.end();
+        }
+    } // namespace Log
+} // namespace OpenKNX
@@ -0,0 +1,33 @@
+#pragma once
+#include "OpenKNX/Log/Sink.h"
+
+namespace OpenKNX
+{
+    namespace Log
+    {
+        /*
+         * Keeps the last output in RAM (oldest bytes are overwritten), shown with console command "log sink memory"
+         */
+        class MemorySink : public Sink
+        {
+          private:
+            uint8_t* _buffer = nullptr;
+            uint32_t _capacity = 0;
+            uint32_t _position = 0;
+            bool _wrapped = false;
+
+          protected:
+            void writeOutput(const uint8_t* data, size_t size) override;
+
+          public:
+            MemorySink(uint32_t capacity, uint8_t level, bool ansi = false);
+            const char* name() override;
+            void show() override;
+
+            /*
+             * Write the content (oldest first)
+             */
+            void print(Print& out);
+        };
+    } // namespace Log
+} // namespace OpenKNX
@@ -0,0 +1,38 @@
+#include "OpenKNX/Log/Logger.h"
+
+namespace OpenKNX
+{
+    namespace Log
+    {
+        void Prefix::set(const char* prefix)
+        {
+            strncpy(_value, prefix, OPENKNX_MAX_LOG_PREFIX_LENGTH);
+            _value[OPENKNX_MAX_LOG_PREFIX_LENGTH] = 0;
+        }
+
+        void Prefix::set(const char* prefix, const char* id)
+        {
+            snprintf(_value, sizeof(_value), "%s<%s>", prefix, id);
+        }
+
+        void Prefix::set(const char* prefix, const int id)
+        {
+            snprintf(_value, sizeof(_value), "%s<%i>", prefix, id);
+        }
+
+        bool Prefix::empty() const
+        {
+            return _value[0] == 0;
+        }
+
+        const char* Prefix::c_str() const
+        {
+            return _value;
+        }
+
+        Prefix::operator const char*() const
+        {
+            return _value;
+        }
+    } // namespace Log
+} // namespace OpenKNX
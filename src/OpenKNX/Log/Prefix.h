@@ -0,0 +1,55 @@
+#pragma once
+#include "Arduino.h"
+#include "OpenKNX/defines.h"
+#include <string>
+
+namespace OpenKNX
+{
+    namespace Log
+    {
+        /*
+         * Log prefix in a fixed buffer (truncated at OPENKNX_MAX_LOG_PREFIX_LENGTH).
+         * Build it once (e.g. per module or channel) and pass it to the logger without heap allocation.
+         */
+        class Prefix
+        {
+          private:
+            char _value[OPENKNX_MAX_LOG_PREFIX_LENGTH + 1] = {};
+
+          public:
+            void set(const char* prefix);
+            // Format is: prefix<id>
+            void set(const char* prefix, const char* id);
+            void set(const char* prefix, const int id);
+
+            bool empty() const;
+            const char* c_str() const;
+            operator const char*() const;
+        };
+    } // namespace Log
+} // namespace OpenKNX
+
+/*
+ * Prefix used by the logXxxP macros. By default it is logPrefix() itself (as std::string or const char*).
+ * A module or channel can opt in to build its prefix once from logPrefix() into a fixed buffer
+ * by putting OPENKNX_CACHED_LOG_PREFIX into its class declaration (costs OPENKNX_MAX_LOG_PREFIX_LENGTH + 1 bytes RAM per instance).
+ */
+template <typename F>
+inline auto cachedLogPrefix(F logPrefix) -> decltype(logPrefix())
+{
+    return logPrefix();
+}
+
+// note: members declared after the macro are private
+#define OPENKNX_CACHED_LOG_PREFIX                                           \
+  protected:                                                                \
+    OpenKNX::Log::Prefix _cachedLogPrefix;                                  \
+    template <typename F>                                                   \
+    const char *cachedLogPrefix(F)                                          \
+    {                                                                       \
+        if (_cachedLogPrefix.empty())                                       \
+            _cachedLogPrefix.set(std::string(logPrefix()).c_str());         \
+        return _cachedLogPrefix;                                            \
+    }                                                                       \
+                                                                            \
+  private:
@@ -0,0 +1,74 @@
+#include "OpenKNX/Log/RingBuffer.h"
+
+namespace OpenKNX
+{
+    namespace Log
+    {
+        RingBuffer::RingBuffer(uint32_t capacity)
+        {
+            _capacity = capacity;
+            _buffer = new uint8_t[capacity];
+        }
+
+        void RingBuffer::copyIn(uint32_t position, const uint8_t* data, uint16_t size)
+        {
+            const uint32_t offset = position & (_capacity - 1);
+            const uint32_t first = MIN((uint32_t)size, _capacity - offset);
+            memcpy(_buffer + offset, data, first);
+            memcpy(_buffer, data + first, size - first);
+        }
+
+        void RingBuffer::copyOut(uint32_t position, uint8_t* data, uint16_t size)
+        {
+            const uint32_t offset = position & (_capacity - 1);
+            const uint32_t first = MIN((uint32_t)size, _capacity - offset);
+            memcpy(data, _buffer + offset, first);
+            memcpy(data + first, _buffer, size - first);
+        }
+
+        bool RingBuffer::push(const uint8_t* data, uint16_t size, uint8_t type /* = 0 */)
+        {
+            const uint32_t head = _head;
+            if (_capacity - (head - _tail) < (uint32_t)size + 3)
+                return false;
+
+            const uint8_t header[3] = {(uint8_t)(size & 0xFF), (uint8_t)(size >> 8), type};
+            copyIn(head, header, 3);
+            copyIn(head + 3, data, size);
+
+            // publish the record after its content is written
+            __sync_synchronize();
+            _head = head + 3 + size;
+            return true;
+        }
+
+        uint16_t RingBuffer::pop(uint8_t* buffer, uint16_t bufferSize, uint8_t& type)
+        {
+            const uint32_t tail = _tail;
+            if (tail == _head)
+                return 0;
+
+            __sync_synchronize();
+            uint8_t header[3];
+            copyOut(tail, header, 3);
+            const uint16_t size = header[0] | (header[1] << 8);
+            type = header[2];
+            copyOut(tail + 3, buffer, MIN(size, bufferSize));
+
+            // release the space after the content is read
+            __sync_synchronize();
+            _tail = tail + 3 + size;
+            return MIN(size, bufferSize);
+        }
+
+        bool RingBuffer::empty()
+        {
+            return _tail == _head;
+        }
+
+        uint32_t RingBuffer::used()
+        {
+            return _head - _tail;
+        }
+    } // namespace Log
+} // namespace OpenKNX
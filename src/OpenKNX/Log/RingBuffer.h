@@ -0,0 +1,41 @@
+#pragma once
+#include "Arduino.h"
+
+namespace OpenKNX
+{
+    namespace Log
+    {
+        /*
+         * Fixed-size ring of records (SIZE[2] ; TYPE[1] ; DATA[SIZE]) without locks between writer and reader.
+         * Only one writer and one reader may be active at the same time (writers are serialized by the logger lock).
+         * The capacity must be a power of two, because positions are running freely and only masked on access.
+         */
+        class RingBuffer
+        {
+          private:
+            uint8_t* _buffer = nullptr;
+            uint32_t _capacity = 0;
+            volatile uint32_t _head = 0; // only changed by writer
+            volatile uint32_t _tail = 0; // only changed by reader
+            void copyIn(uint32_t position, const uint8_t* data, uint16_t size);
+            void copyOut(uint32_t position, uint8_t* data, uint16_t size);
+
+          public:
+            RingBuffer(uint32_t capacity);
+
+            /*
+             * Append a record. Returns false (without blocking) if there is not enough space.
+             */
+            bool push(const uint8_t* data, uint16_t size, uint8_t type = 0);
+
+            /*
+             * Remove the oldest record and copy it into buffer (truncated to bufferSize).
+             * Returns the size of the record or 0 if the ring is empty.
+             */
+            uint16_t pop(uint8_t* buffer, uint16_t bufferSize, uint8_t& type);
+
+            bool empty();
+            uint32_t used();
+        };
+    } // namespace Log
+} // namespace OpenKNX
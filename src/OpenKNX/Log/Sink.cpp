@@ -0,0 +1,72 @@
+#include "OpenKNX/Log/Sink.h"
+
+namespace OpenKNX
+{
+    namespace Log
+    {
+        Sink::Sink(uint8_t level, bool ansi)
+        {
+            _level = level;
+            _ansi = ansi;
+        }
+
+        uint8_t Sink::level()
+        {
+            return _level;
+        }
+
+        void Sink::level(uint8_t level)
+        {
+            _level = level;
+        }
+
+        bool Sink::ansi()
+        {
+            return _ansi;
+        }
+
+        void Sink::write(const uint8_t* data, size_t size)
+        {
+            if (_ansi)
+            {
+                writeOutput(data, size);
+                return;
+            }
+
+            // remove escape sequences (ESC [ ... final byte), also if split between two parts
+            size_t start = 0;
+            for (size_t i = 0; i < size; i++)
+            {
+                if (_escape)
+                {
+                    if (data[i] >= 0x40 && data[i] <= 0x7E && data[i] != '[')
+                        _escape = false;
+
+                    start = i + 1;
+                }
+                else if (data[i] == 0x1B)
+                {
+                    if (i > start)
+                        writeOutput(data + start, i - start);
+
+                    _escape = true;
+                    start = i + 1;
+                }
+            }
+
+            if (size > start)
+                writeOutput(data + start, size - start);
+        }
+
+        bool Sink::immediate()
+        {
+            return false;
+        }
+
+        void Sink::loop() {}
+
+        void Sink::flush() {}
+
+        void Sink::show() {}
+    } // namespace Log
+} // namespace OpenKNX
@@ -0,0 +1,60 @@
+#pragma once
+#include "Arduino.h"
+
+namespace OpenKNX
+{
+    namespace Log
+    {
+        /*
+         * Additional output of the logger (beside the console device).
+         * Each line is formatted once and the bytes are passed to all sinks with a level below or equal to the line.
+         * Without ansi, escape sequences (e.g. colors) are removed before writeOutput.
+         */
+        class Sink
+        {
+          private:
+            bool _escape = false;
+
+          protected:
+            uint8_t _level;
+            bool _ansi;
+
+            /*
+             * Write a complete line or a part of a long line (e.g. hex dump).
+             * Called within the logger lock and from both cores, so it must not block or log.
+             */
+            virtual void writeOutput(const uint8_t* data, size_t size) = 0;
+
+          public:
+            Sink(uint8_t level, bool ansi);
+
+            virtual const char* name() = 0;
+            uint8_t level();
+            void level(uint8_t level);
+            bool ansi();
+
+            void write(const uint8_t* data, size_t size);
+
+            /*
+             * Immediate sinks get each line when it is logged, also with OPENKNX_LOGGER_ASYNC
+             * (e.g. to keep lines before a hang), so writeOutput must be fast.
+             */
+            virtual bool immediate();
+
+            /*
+             * Called in logger loop on core0 (e.g. to write buffered output)
+             */
+            virtual void loop();
+
+            /*
+             * Write all buffered output (e.g. before restart)
+             */
+            virtual void flush();
+
+            /*
+             * Show content or state on the console
+             */
+            virtual void show();
+        };
+    } // namespace Log
+} // namespace OpenKNX
@@ -0,0 +1,23 @@
+#include "OpenKNX/Log/StreamSink.h"
+
+namespace OpenKNX
+{
+    namespace Log
+    {
+        StreamSink::StreamSink(const char* name, Print& stream, uint8_t level, bool ansi)
+            : Sink(level, ansi), _stream(stream)
+        {
+            _name = name;
+        }
+
+        const char* StreamSink::name()
+        {
+            return _name;
+        }
+
+        void StreamSink::writeOutput(const uint8_t* data, size_t size)
+        {
+            _stream.write(data, size);
+        }
+    } // namespace Log
+} // namespace OpenKNX
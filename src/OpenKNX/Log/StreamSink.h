@@ -0,0 +1,25 @@
+#pragma once
+#include "OpenKNX/Log/Sink.h"
+
+namespace OpenKNX
+{
+    namespace Log
+    {
+        /*
+         * Sink for an additional stream (e.g. a second serial or RTT)
+         */
+        class StreamSink : public Sink
+        {
+          private:
+            Print& _stream;
+            const char* _name;
+
+          protected:
+            void writeOutput(const uint8_t* data, size_t size) override;
+
+          public:
+            StreamSink(const char* name, Print& stream, uint8_t level, bool ansi = true);
+            const char* name() override;
+        };
+    } // namespace Log
+} // namespace OpenKNX
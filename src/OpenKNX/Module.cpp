@@ -12,6 +12,26 @@ namespace OpenKNX
 
     void Module::readFlash(const uint8_t *data, const uint16_t size) {}
 
+    uint8_t Module::flashVersion()
+    {
+        return 0;
+    }
+
+    bool Module::migrateFlash(const uint8_t *data, const uint16_t size, const uint8_t version)
+    {
+        return false;
+    }
+
+    SavePolicy Module::savePolicy()
+    {
+        return SavePolicy();
+    }
+
+    void Module::requestSave()
+    {
+        openknx.common.requestSave(this);
+    }
+
     void Module::processAfterStartupDelay() {}
 
     void Module::processBeforeRestart() {}
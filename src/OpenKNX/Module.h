@@ -3,6 +3,20 @@
 
 namespace OpenKNX
 {
+    /*
+     * Defines when a save requested by a module (Module::requestSave) is executed
+     */
+    struct SavePolicy
+    {
+        // min. time since the last save (ms)
+        uint32_t minInterval = 0;
+        // time after the last request, so a series of changes results in one save (ms)
+        uint32_t debounce = 0;
+        // critical data is saved at the earliest allowed moment.
+        // best-effort data additionally waits FLASH_DATA_WRITE_LIMIT since the last save or is saved together with other data.
+        bool critical = false;
+    };
+
     /*
      * Abstract class for Modules
      */
@@ -40,6 +54,34 @@ namespace OpenKNX
          */
         virtual void readFlash(const uint8_t *data, const uint16_t size);
 
+        /*
+         * Schema version of the module data in flash. Increase it on every change of the data layout.
+         * @return version (default 0)
+         */
+        virtual uint8_t flashVersion();
+
+        /*
+         * Called on load instead of readFlash, when the data in flash was written with another flashVersion().
+         * The module has to restore its state from the old layout (the data will be saved in the new layout on next save).
+         * @param data pointer to data of module in flash (read helper of FlashStorage can be used as well)
+         * @param size number of saved bytes in flash
+         * @param version schema version of the saved data
+         * @return false if the migration is not supported, then readFlash is called with size 0 (init)
+         */
+        virtual bool migrateFlash(const uint8_t *data, const uint16_t size, const uint8_t version);
+
+        /*
+         * Save policy for the requests of this module (see requestSave)
+         * @return policy (default best-effort without own interval and debounce)
+         */
+        virtual SavePolicy savePolicy();
+
+        /*
+         * Requests to save the module data according to savePolicy().
+         * Pending requests of all modules are coalesced into one save.
+         */
+        void requestSave();
+
         /*
          * Called after the startup delay time are expired.
          */
@@ -62,6 +62,43 @@
 
 #endif
 
+#ifndef OPENKNX_FLASH_SLOTS
+    // pre-erased slot for power failure (on RP2040 same layout as the former A/B slots)
+    #define OPENKNX_FLASH_SLOTS 2
+#endif
+
+#if OPENKNX_FLASH_SLOTS < 1 || OPENKNX_FLASH_SLOTS > 127
+    #error "OPENKNX_FLASH_SLOTS must be between 1 and 127"
+#endif
+
+#ifndef OPENKNX_FLASH_KV_SIZE
+    #define OPENKNX_FLASH_KV_SIZE 0
+#endif
+
+#ifndef OPENKNX_FLASH_KV_ENTRIES
+    #define OPENKNX_FLASH_KV_ENTRIES 32
+#endif
+
+#ifndef OPENKNX_FLASH_TELEMETRY_INTERVAL
+    #define OPENKNX_FLASH_TELEMETRY_INTERVAL 3600000
+#endif
+
+#ifndef OPENKNX_FLASH_ENDURANCE
+    #define OPENKNX_FLASH_ENDURANCE 100000
+#endif
+
+#ifndef OPENKNX_FLASH_TELEMETRY_PROPERTY_OBJECT
+    #define OPENKNX_FLASH_TELEMETRY_PROPERTY_OBJECT 159
+#endif
+
+#ifndef OPENKNX_FLASH_TELEMETRY_PROPERTY_ID
+    #define OPENKNX_FLASH_TELEMETRY_PROPERTY_ID 1
+#endif
+
+#ifndef OPENKNX_FLASH_CACHE_SECTORS
+    #define OPENKNX_FLASH_CACHE_SECTORS 4
+#endif
+
 #ifndef KNX_SERIAL
     #define KNX_SERIAL Serial1
 #endif